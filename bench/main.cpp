@@ -0,0 +1,332 @@
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-data/i_list_data_source.h"
+#include "floah-data/integral_value_data_source.h"
+#include "floah-layout/elements/vertical_flow.h"
+#include "floah-put/input_context.h"
+#include "floah-viz/font_map.h"
+#include "floah-viz/scenegraph/scenegraph_generator.h"
+#include "floah-viz/stylesheet.h"
+#include "sol/material/forward/forward_material_instance.h"
+#include "sol/mesh/mesh_manager.h"
+#include "sol/scenegraph/forward/forward_material_node.h"
+#include "sol/scenegraph/node.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/panel.h"
+#include "floah-widget/widgets/checkbox.h"
+#include "floah-widget/widgets/dropdown.h"
+#include "floah-widget/widgets/radio_button.h"
+
+////////////////////////////////////////////////////////////////
+// Allocation counting.
+////////////////////////////////////////////////////////////////
+
+namespace
+{
+    std::atomic<size_t> allocations = 0;
+}  // namespace
+
+void* operator new(const size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // The size passed to aligned_alloc must be a multiple of the alignment.
+    const auto align = static_cast<size_t>(alignment);
+    const auto bytes = size == 0 ? align : (size + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, bytes)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////
+    // Measuring.
+    ////////////////////////////////////////////////////////////////
+
+    struct Measurement
+    {
+        double milliseconds = 0;
+        size_t allocations  = 0;
+    };
+
+    template<typename F>
+    Measurement measure(F&& f)
+    {
+        const auto allocs = allocations.load();
+        const auto start  = std::chrono::steady_clock::now();
+        f();
+        const auto end = std::chrono::steady_clock::now();
+        return {.milliseconds = std::chrono::duration<double, std::milli>(end - start).count(),
+                .allocations  = allocations.load() - allocs};
+    }
+
+    void report(const char* widget, const size_t count, const char* stage, const Measurement& m)
+    {
+        std::printf("%-12s %8zu  %-26s %12.3f ms %12zu allocs\n", widget, count, stage, m.milliseconds, m.allocations);
+    }
+
+    void report(const char* widget, const size_t count, const char* stage, const size_t value)
+    {
+        std::printf("%-12s %8zu  %-26s %15zu\n", widget, count, stage, value);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scenegraph generator.
+    ////////////////////////////////////////////////////////////////
+
+    [[nodiscard]] size_t countNodes(sol::Node& node)
+    {
+        size_t count = 1;
+        for (const auto& child : node.getChildren()) count += countNodes(*child);
+        return count;
+    }
+
+    class TransformNode final : public sol::Node, public floah::ITransformNode
+    {
+    public:
+        explicit TransformNode(const math::float3 o) : offset(o) {}
+
+        [[nodiscard]] sol::Node& getAsNode() override { return *this; }
+
+        void setOffset(const math::float3 o) override { offset = o; }
+
+        void setZ(const float z) override { offset[2] = z; }
+
+        math::float3 offset;
+    };
+
+    /**
+     * \brief Builds plain node trees on the CPU. Widget nodes without a parent become roots owned by the generator.
+     */
+    class ScenegraphGenerator final : public floah::IScenegraphGenerator
+    {
+    public:
+        [[nodiscard]] size_t countNodes() const
+        {
+            size_t count = 0;
+            for (const auto& root : roots) count += ::countNodes(*root);
+            return count;
+        }
+
+        [[nodiscard]] sol::Node& createWidgetNode(sol::Node* parent) override
+        {
+            if (parent) return parent->addChild(std::make_unique<sol::Node>());
+            return *roots.emplace_back(std::make_unique<sol::Node>());
+        }
+
+        [[nodiscard]] sol::Node& createTextMaterialNode(sol::Node&                    parent,
+                                                        sol::ForwardMaterialInstance& material) override
+        {
+            auto& node = parent.addChild(std::make_unique<sol::ForwardMaterialNode>());
+            node.setMaterial(&material);
+            return node;
+        }
+
+        [[nodiscard]] floah::ITransformNode& createWidgetTransformNode(sol::Node&         parent,
+                                                                       const math::float3 offset) override
+        {
+            return parent.addChild(std::make_unique<TransformNode>(offset));
+        }
+
+    private:
+        std::vector<std::unique_ptr<sol::Node>> roots;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Data sources.
+    ////////////////////////////////////////////////////////////////
+
+    class ItemsSource final : public floah::IListDataSource
+    {
+    public:
+        [[nodiscard]] size_t getSize() const override { return 64; }
+
+        [[nodiscard]] std::string getString(const size_t index) const override
+        {
+            return "Item " + std::to_string(index);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // Input.
+    ////////////////////////////////////////////////////////////////
+
+    void moveMouse(floah::InputContext& context, const math::int2 position) { context.mouseMove(position); }
+
+    void clickMouse(floah::InputContext& context)
+    {
+        context.mouseClick(floah::InputContext::MouseButton::Left, floah::InputContext::MouseAction::Press);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scenarios.
+    ////////////////////////////////////////////////////////////////
+
+    constexpr int32_t row_height = 24;
+
+    /**
+     * \brief Shared state of all scenarios. Everything runs on the CPU: meshes, materials and fonts are stand-ins that
+     * keep their data in memory.
+     */
+    struct Environment
+    {
+        sol::MeshManager             meshManager;
+        floah::FontMap               fontMap;
+        sol::ForwardMaterialInstance widgetMaterial;
+        sol::ForwardMaterialInstance textMaterial;
+        floah::Stylesheet            stylesheet;
+        ItemsSource                  items;
+
+        Environment()
+        {
+            stylesheet.set<sol::ForwardMaterialInstance*>(floah::Widget::material_widget, &widgetMaterial);
+            stylesheet.set<sol::ForwardMaterialInstance*>(floah::Widget::material_text, &textMaterial);
+        }
+    };
+
+    /**
+     * \brief Build a panel with count widgets stacked vertically and measure all stages.
+     * \tparam T Widget type.
+     * \param env Environment.
+     * \param name Widget name.
+     * \param count Number of widgets.
+     */
+    template<std::derived_from<floah::Widget> T>
+    void run(Environment& env, const char* name, const size_t count)
+    {
+        floah::InputContext context;
+        floah::Panel        panel(context);
+        ScenegraphGenerator generator;
+        panel.setStylesheet(&env.stylesheet);
+
+        auto& root = panel.getLayout().setRoot(std::make_unique<floah::VerticalFlow>());
+        panel.getLayout().getSize() =
+          floah::Size(floah::Length(1920), floah::Length(static_cast<int32_t>(count) * row_height));
+
+        std::vector<floah::LayoutElement*> elements;
+        elements.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& elem = root.append(std::make_unique<floah::LayoutElement>());
+            elem.getSize().setWidth(floah::Length(1.0f));
+            elem.getSize().setHeight(floah::Length(row_height));
+            elements.push_back(&elem);
+        }
+
+        // Every dropdown gets its own index, so that selecting an item in one does not make the others stale.
+        std::vector<std::unique_ptr<floah::IntegralValueDataSource<size_t>>> indices;
+        std::vector<std::unique_ptr<T>>                                      ws;
+        ws.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& w = *ws.emplace_back(std::make_unique<T>());
+            w.setLabel("Label " + std::to_string(i % 16));
+            if constexpr (std::same_as<T, floah::Dropdown>)
+            {
+                w.setItemsDataSource(&env.items);
+                w.setIndexDataSource(
+                  indices.emplace_back(std::make_unique<floah::IntegralValueDataSource<size_t>>(i % 8)).get());
+            }
+        }
+
+        // Add widgets.
+        std::vector<T*> refs;
+        report(name, count, "add", measure([&] { refs = panel.addWidgets(std::move(ws)); }));
+        for (size_t i = 0; i < count; i++) refs[i]->setPanelLayoutElement(*elements[i]);
+
+        // Layout.
+        report(name, count, "panel layout", measure([&] { panel.generatePanelLayout(); }));
+        report(name, count, "widget layout", measure([&] { panel.generateWidgetLayouts(); }));
+
+        // Geometry generation. Identical shapes and texts share their meshes.
+        report(name, count, "geometry", measure([&] { panel.generateGeometry(env.meshManager, env.fontMap); }));
+        report(name, count, "meshes", env.meshManager.getMeshCount());
+
+        // Scenegraph generation.
+        report(name, count, "scenegraph", measure([&] { panel.generateScenegraph(generator); }));
+        report(name, count, "nodes", generator.countNodes());
+
+        // Resize, forcing a full relayout in parallel.
+        panel.getLayout().getSize().setWidth(floah::Length(1600));
+        panel.setExecutionMode(floah::Panel::ExecutionMode::Parallel);
+        report(name, count, "panel relayout (resize)", measure([&] { panel.generatePanelLayout(); }));
+        report(name, count, "widget layout (parallel)", measure([&] { panel.generateWidgetLayouts(); }));
+        panel.setExecutionMode(floah::Panel::ExecutionMode::Serial);
+        report(name, count, "geometry (resize)", measure([&] {
+                   panel.generateGeometry(env.meshManager, env.fontMap);
+               }));
+        report(name, count, "scenegraph (resize)", measure([&] { panel.generateScenegraph(generator); }));
+
+        // Move, which only translates widget layouts and transform nodes.
+        panel.getLayout().getOffset().setHeight(floah::Length(-row_height));
+        report(name, count, "panel relayout (move)", measure([&] { panel.generatePanelLayout(); }));
+        report(name, count, "scenegraph (move)", measure([&] { panel.generateScenegraph(generator); }));
+
+        // Input dispatch: move the mouse down a column of widgets and click each of them.
+        report(name, count, "input dispatch", measure([&] {
+                   for (int32_t y = 0; y < 256 * row_height; y += row_height)
+                   {
+                       moveMouse(context, math::int2(8, y + row_height / 2));
+                       clickMouse(context);
+                   }
+               }));
+
+        // Widgets that were clicked are regenerated by the next update.
+        report(name, count, "update (after input)", measure([&] {
+                   panel.update(env.meshManager, env.fontMap, generator);
+               }));
+
+        // Destroy all widgets, their nodes and their meshes.
+        report(name, count, "release", measure([&] { panel.release(); }));
+        report(name, count, "meshes (after release)", env.meshManager.getMeshCount());
+    }
+
+    template<std::derived_from<floah::Widget> T>
+    void runAll(Environment& env, const char* name)
+    {
+        for (const size_t count : {100, 1000, 10000, 100000}) run<T>(env, name, count);
+    }
+}  // namespace
+
+int main()
+{
+    Environment env;
+    runAll<floah::Checkbox>(env, "Checkbox");
+    runAll<floah::RadioButton>(env, "RadioButton");
+    runAll<floah::Dropdown>(env, "Dropdown");
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace floah
+{
+    /**
+     * \brief Stand-in for a font map with fixed-size glyphs, so that text geometry can be generated without loading
+     * a font.
+     */
+    class FontMap
+    {
+    public:
+        [[nodiscard]] float getAdvance() const noexcept { return advance; }
+
+        [[nodiscard]] float getLineHeight() const noexcept { return lineHeight; }
+
+        float advance = 8.0f;
+
+        float lineHeight = 16.0f;
+    };
+}  // namespace floah
@@ -0,0 +1,34 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+#include "sol/material/fwd.h"
+#include "sol/scenegraph/node.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/scenegraph/transform_node.h"
+
+namespace floah
+{
+    /**
+     * \brief Interface that creates the nodes that widgets need but cannot create themselves.
+     */
+    class IScenegraphGenerator
+    {
+    public:
+        virtual ~IScenegraphGenerator() noexcept = default;
+
+        [[nodiscard]] virtual sol::Node& createWidgetNode(sol::Node* parent) = 0;
+
+        [[nodiscard]] virtual sol::Node& createTextMaterialNode(sol::Node&                    parent,
+                                                                sol::ForwardMaterialInstance& material) = 0;
+
+        [[nodiscard]] virtual ITransformNode& createWidgetTransformNode(sol::Node& parent, math::float3 offset) = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,18 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/material/fwd.h"
+
+namespace sol
+{
+    /**
+     * \brief Stand-in for a material instance, whose parameters live in device memory. Widgets only use its address,
+     * to group nodes and batches.
+     */
+    class ForwardMaterialInstance
+    {
+    };
+}  // namespace sol
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace sol
+{
+    class ForwardMaterialInstance;
+}  // namespace sol
@@ -0,0 +1,42 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/i_mesh.h"
+
+namespace sol
+{
+    /**
+     * \brief Stand-in for a non-indexed mesh. Vertices are kept in CPU memory instead of being uploaded.
+     */
+    class FlatMesh final : public IMesh
+    {
+    public:
+        struct Vertex
+        {
+            math::float3 position;
+
+            math::float2 uv;
+
+            math::float4 color;
+        };
+
+        using IMesh::IMesh;
+
+        std::vector<Vertex> vertices;
+    };
+}  // namespace sol
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace sol
+{
+    class FlatMesh;
+    class IMesh;
+    class MeshManager;
+}  // namespace sol
@@ -0,0 +1,54 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/fwd.h"
+
+namespace sol
+{
+    /**
+     * \brief Stand-in for a mesh that lives in CPU memory only.
+     */
+    class IMesh
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        IMesh() = delete;
+
+        IMesh(MeshManager& manager, const uint64_t id) : meshManager(&manager), uuid(id) {}
+
+        IMesh(const IMesh&) = delete;
+
+        IMesh(IMesh&&) noexcept = delete;
+
+        virtual ~IMesh() noexcept = default;
+
+        IMesh& operator=(const IMesh&) = delete;
+
+        IMesh& operator=(IMesh&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] MeshManager& getMeshManager() const noexcept { return *meshManager; }
+
+        [[nodiscard]] uint64_t getUuid() const noexcept { return uuid; }
+
+    private:
+        MeshManager* meshManager = nullptr;
+
+        uint64_t uuid = 0;
+    };
+}  // namespace sol
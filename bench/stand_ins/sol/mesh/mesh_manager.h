@@ -0,0 +1,52 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/flat_mesh.h"
+
+namespace sol
+{
+    /**
+     * \brief Stand-in for the mesh manager that creates meshes in CPU memory, so that geometry generation can be
+     * measured without a device.
+     */
+    class MeshManager
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t getMeshCount() const noexcept { return meshes.size(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Meshes.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] FlatMesh& createFlatMesh()
+        {
+            const auto id   = nextUuid++;
+            auto       mesh = std::make_unique<FlatMesh>(*this, id);
+            auto&      ref  = *mesh;
+            meshes.try_emplace(id, std::move(mesh));
+            return ref;
+        }
+
+        void destroyMesh(const uint64_t uuid) { meshes.erase(uuid); }
+
+    private:
+        std::unordered_map<uint64_t, std::unique_ptr<IMesh>> meshes;
+
+        uint64_t nextUuid = 0;
+    };
+}  // namespace sol
@@ -0,0 +1,79 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/fwd.h"
+#include "sol/scenegraph/fwd.h"
+
+namespace floah
+{
+    class InstanceBatch;
+    class StaticBatch;
+
+    /**
+     * \brief Implemented by the application to turn the batches of a panel into meshes and nodes. Uploading vertices
+     * and instances requires the device, which this module has no access to. The panel puts every batch into a node
+     * under the material node of its batch, so that each batch is drawn with a single draw call.
+     */
+    class IBatchGenerator
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        IBatchGenerator() = default;
+
+        IBatchGenerator(const IBatchGenerator&) = default;
+
+        IBatchGenerator(IBatchGenerator&&) noexcept = default;
+
+        virtual ~IBatchGenerator() noexcept = default;
+
+        IBatchGenerator& operator=(const IBatchGenerator&) = default;
+
+        IBatchGenerator& operator=(IBatchGenerator&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Static batches.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create a mesh holding all vertices of a static batch.
+         * \param batch Batch.
+         * \return Mesh. Destroyed through its mesh manager after the batch was destroyed.
+         */
+        [[nodiscard]] virtual sol::IMesh& createStaticBatchMesh(const StaticBatch& batch) = 0;
+
+        /**
+         * \brief Upload the vertices in the dirty range of a static batch into its mesh. The number of vertices may
+         * have changed since the mesh was created or last updated.
+         * \param mesh Mesh created by createStaticBatchMesh.
+         * \param batch Batch.
+         */
+        virtual void updateStaticBatchMesh(sol::IMesh& mesh, const StaticBatch& batch) = 0;
+
+        ////////////////////////////////////////////////////////////////
+        // Instance batches.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create a node that draws the mesh of an instance batch once for every instance that is not hidden,
+         * with a single instanced draw.
+         * \param parent Material node of the batch. The node must be added as a child of it.
+         * \param batch Batch.
+         * \return Node. Detached after the batch was destroyed.
+         */
+        [[nodiscard]] virtual sol::Node& createInstanceBatchNode(sol::Node& parent, const InstanceBatch& batch) = 0;
+
+        /**
+         * \brief Upload the instances in the dirty range of an instance batch. The number of instances may have
+         * changed since the node was created or last updated.
+         * \param node Node created by createInstanceBatchNode.
+         * \param batch Batch.
+         */
+        virtual void updateInstanceBatchNode(sol::Node& node, const InstanceBatch& batch) = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,103 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/fwd.h"
+#include "sol/scenegraph/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/mesh_cache.h"
+#include "floah-widget/text_mesh_cache.h"
+
+namespace floah
+{
+    /**
+     * \brief Queue of scenegraph nodes and meshes that are no longer used by destroyed widgets. Everything is destroyed
+     * together when the queue is flushed, which the panel does once per update. Nodes are disabled and cleared before
+     * meshes are released, so that a mesh is never destroyed while a node still refers to it.
+     */
+    class DestructionQueue
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        DestructionQueue() = default;
+
+        DestructionQueue(const DestructionQueue&) = delete;
+
+        DestructionQueue(DestructionQueue&&) noexcept = default;
+
+        /**
+         * \brief Flushes the queue.
+         */
+        ~DestructionQueue() noexcept;
+
+        DestructionQueue& operator=(const DestructionQueue&) = delete;
+
+        DestructionQueue& operator=(DestructionQueue&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Queue.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Disable a node, and clear the meshes of it and its children, when the queue is flushed.
+         * \param node Node.
+         */
+        void enqueue(sol::Node& node);
+
+        /**
+         * \brief Release a mesh when the queue is flushed.
+         * \param cache Cache the mesh was acquired from. Must outlive the queue or its next flush.
+         * \param mesh Mesh or nullptr.
+         */
+        void enqueue(MeshCache& cache, const sol::IMesh* mesh);
+
+        /**
+         * \brief Release a text mesh when the queue is flushed.
+         * \param cache Cache the mesh was acquired from. Must outlive the queue or its next flush.
+         * \param mesh Mesh or nullptr.
+         */
+        void enqueue(TextMeshCache& cache, const sol::IMesh* mesh);
+
+        /**
+         * \brief Destroy a mesh that is not shared through a cache when the queue is flushed.
+         * \param mesh Mesh.
+         */
+        void enqueue(sol::IMesh& mesh);
+
+        /**
+         * \brief Disable all queued nodes, then release all queued meshes.
+         */
+        void flush();
+
+    private:
+        std::vector<sol::Node*> nodes;
+
+        std::vector<std::pair<MeshCache*, const sol::IMesh*>> meshes;
+
+        std::vector<std::pair<TextMeshCache*, const sol::IMesh*>> textMeshes;
+
+        std::vector<sol::IMesh*> ownedMeshes;
+    };
+}  // namespace floah
@@ -0,0 +1,251 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+#include "sol/material/fwd.h"
+#include "sol/mesh/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/slot_map.h"
+
+namespace floah
+{
+    class InstanceBatch;
+
+    /**
+     * \brief Per-instance data of a widget shape that is drawn instanced. Tightly packed, so that the instances of a
+     * batch can be uploaded as is.
+     */
+    struct InstanceData
+    {
+        enum class Flags : uint32_t
+        {
+            None = 0,
+
+            /**
+             * \brief Instance should not be drawn, e.g. a highlight that is not active.
+             */
+            Hidden = 1
+        };
+
+        /**
+         * \brief Offset of the mesh, which is centered around the origin. The z coordinate is the layer depth.
+         */
+        math::float3 offset;
+
+        Flags flags = Flags::None;
+    };
+
+    /**
+     * \brief Handle to an instance in an InstanceBatch.
+     */
+    struct InstanceHandle
+    {
+        InstanceBatch* batch = nullptr;
+
+        SlotMapHandle handle;
+
+        [[nodiscard]] bool valid() const noexcept { return batch != nullptr; }
+    };
+
+    /**
+     * \brief All instances of a widget type that draw the same mesh with the same material.
+     */
+    class InstanceBatch
+    {
+        friend class InstanceBatches;
+
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InstanceBatch() = delete;
+
+        InstanceBatch(std::type_index widgetType, sol::IMesh& batchMesh, sol::ForwardMaterialInstance* batchMaterial);
+
+        InstanceBatch(const InstanceBatch&) = delete;
+
+        InstanceBatch(InstanceBatch&&) noexcept = delete;
+
+        ~InstanceBatch() noexcept = default;
+
+        InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+        InstanceBatch& operator=(InstanceBatch&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] std::type_index getType() const noexcept;
+
+        [[nodiscard]] sol::IMesh& getMesh() const noexcept;
+
+        [[nodiscard]] sol::ForwardMaterialInstance* getMaterial() const noexcept;
+
+        /**
+         * \brief Get the instances of this batch. Their order changes when instances are destroyed.
+         * \return Instances.
+         */
+        [[nodiscard]] std::span<const InstanceData> getInstances() const noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * \brief Get the range of instances that were modified since the dirty range was last cleared. Instances past
+         * the end of the batch were destroyed.
+         * \return Index of first and one past the last modified instance. Empty if nothing was modified.
+         */
+        [[nodiscard]] std::pair<size_t, size_t> getDirtyRange() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clear the dirty range, e.g. after uploading the modified instances.
+         */
+        void clearDirtyRange() noexcept;
+
+    private:
+        void markDirty(size_t index) noexcept;
+
+        std::type_index type;
+
+        sol::IMesh* mesh = nullptr;
+
+        sol::ForwardMaterialInstance* material = nullptr;
+
+        SlotMap<InstanceData> instances;
+
+        std::pair<size_t, size_t> dirty;
+    };
+
+    /**
+     * \brief Instance batches of the widgets in a panel. Widgets that are drawn instanced do not create nodes for their
+     * shapes, but keep an instance per shape up to date instead. The panel puts a node for each batch into the
+     * scenegraph, which the IBatchGenerator of the panel creates to draw all instances with one instanced draw.
+     */
+    class InstanceBatches
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        InstanceBatches() = default;
+
+        InstanceBatches(const InstanceBatches&) = delete;
+
+        InstanceBatches(InstanceBatches&&) noexcept = default;
+
+        ~InstanceBatches() noexcept = default;
+
+        InstanceBatches& operator=(const InstanceBatches&) = delete;
+
+        InstanceBatches& operator=(InstanceBatches&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all batches. Batches whose last instance was destroyed are kept until they are taken by
+         * takeEmpty.
+         * \return Batches.
+         */
+        [[nodiscard]] const std::vector<std::unique_ptr<InstanceBatch>>& getBatches() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Instances.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create an instance in the batch of the given widget type, mesh and material.
+         * \param type Widget type.
+         * \param mesh Mesh.
+         * \param material Material.
+         * \param data Instance data.
+         * \return Handle.
+         */
+        [[nodiscard]] InstanceHandle
+          create(std::type_index type, sol::IMesh& mesh, sol::ForwardMaterialInstance* material, InstanceData data);
+
+        /**
+         * \brief Update the data of an instance.
+         * \param handle Handle.
+         * \param data Instance data.
+         */
+        void update(const InstanceHandle& handle, InstanceData data);
+
+        /**
+         * \brief Update an instance, moving it to another batch if the mesh or material changed.
+         * \param handle Handle or invalid handle, in which case a new instance is created. Updated to the new instance.
+         * \param type Widget type.
+         * \param mesh Mesh.
+         * \param material Material.
+         * \param data Instance data.
+         */
+        void replace(InstanceHandle&               handle,
+                     std::type_index               type,
+                     sol::IMesh&                   mesh,
+                     sol::ForwardMaterialInstance* material,
+                     InstanceData                  data);
+
+        /**
+         * \brief Destroy an instance.
+         * \param handle Handle or invalid handle. Reset to an invalid handle.
+         */
+        void destroy(InstanceHandle& handle);
+
+        /**
+         * \brief Take all batches without instances out of this object, e.g. to destroy the nodes that were created for
+         * them before destroying the batches themselves.
+         * \return Empty batches.
+         */
+        [[nodiscard]] std::vector<std::unique_ptr<InstanceBatch>> takeEmpty();
+
+    private:
+        struct Key
+        {
+            std::type_index type;
+
+            const sol::IMesh* mesh = nullptr;
+
+            const sol::ForwardMaterialInstance* material = nullptr;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept;
+        };
+
+        std::vector<std::unique_ptr<InstanceBatch>> batches;
+
+        /**
+         * \brief Index into batches by key.
+         */
+        std::unordered_map<Key, size_t, KeyHash> batchIndex;
+    };
+}  // namespace floah
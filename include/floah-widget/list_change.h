@@ -0,0 +1,110 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-data/i_list_data_source.h"
+
+namespace floah
+{
+    /**
+     * \brief Describes a change to a contiguous range of items in a list.
+     */
+    struct ListChange
+    {
+        enum class Type
+        {
+            /**
+             * \brief Items were inserted before first. Items from first onwards moved back by count.
+             */
+            Insert,
+
+            /**
+             * \brief Items [first, first + count) were removed. Items after them moved forward by count.
+             */
+            Remove,
+
+            /**
+             * \brief Items [first, first + count) were modified in place.
+             */
+            Update
+        };
+
+        Type type = Type::Update;
+
+        size_t first = 0;
+
+        size_t count = 0;
+    };
+
+    /**
+     * \brief Listener for list data sources that can report which items changed. Widgets that implement this can
+     * apply a change incrementally, instead of treating it as a change of the whole list as onDataSourceUpdate does.
+     */
+    class ListChangeListener
+    {
+    public:
+        virtual ~ListChangeListener() noexcept = default;
+
+        /**
+         * \brief Called by a ListChangeNotifier after a range of items in a list data source changed. Called instead
+         * of, not in addition to, onDataSourceUpdate.
+         * \param source List data source.
+         * \param change Change.
+         */
+        virtual void onListDataSourceUpdate(IListDataSource& source, const ListChange& change) = 0;
+    };
+
+    /**
+     * \brief Implemented by list data sources, next to IListDataSource, to report which items changed. Widgets that
+     * implement ListChangeListener subscribe to it when the source is assigned to them.
+     */
+    class ListChangeNotifier
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        ListChangeNotifier() = default;
+
+        ListChangeNotifier(const ListChangeNotifier&) = delete;
+
+        ListChangeNotifier(ListChangeNotifier&&) noexcept = delete;
+
+        virtual ~ListChangeNotifier() noexcept = default;
+
+        ListChangeNotifier& operator=(const ListChangeNotifier&) = delete;
+
+        ListChangeNotifier& operator=(ListChangeNotifier&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Listeners.
+        ////////////////////////////////////////////////////////////////
+
+        void addListChangeListener(ListChangeListener& listener);
+
+        void removeListChangeListener(ListChangeListener& listener);
+
+    protected:
+        /**
+         * \brief Notify all list change listeners of a change. Sources call this instead of notifying their data
+         * listeners, which would make widgets regenerate all items. Data listeners that do not listen for list changes
+         * are not notified by this.
+         * \param source Source that changed, usually this.
+         * \param change Change.
+         */
+        void notifyListChange(IListDataSource& source, const ListChange& change);
+
+    private:
+        std::vector<ListChangeListener*> listeners;
+    };
+}  // namespace floah
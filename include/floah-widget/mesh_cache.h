@@ -0,0 +1,182 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/generators/circle_generator.h"
+#include "floah-viz/generators/generator.h"
+#include "floah-viz/generators/rectangle_generator.h"
+#include "sol/mesh/fwd.h"
+
+namespace floah
+{
+    /**
+     * \brief Parameters of a rectangle mesh. Only these are passed on to the RectangleGenerator, so that the cache key
+     * covers everything that affects the mesh.
+     */
+    struct RectangleShape
+    {
+        math::float2 lower;
+
+        math::float2 upper;
+
+        RectangleGenerator::FillMode fillMode = RectangleGenerator::FillMode::Fill;
+
+        Length margin;
+
+        math::float4 color;
+    };
+
+    /**
+     * \brief Parameters of a circle mesh. Only these are passed on to the CircleGenerator, so that the cache key covers
+     * everything that affects the mesh.
+     */
+    struct CircleShape
+    {
+        CircleGenerator::FillMode fillMode = CircleGenerator::FillMode::Fill;
+
+        float radius = 0;
+    };
+
+    /**
+     * \brief Content-addressed cache of generated meshes. Meshes are keyed by their generator parameters and reference
+     * counted, so that widgets with identical shapes share a single mesh. A mesh is destroyed when its last reference
+     * is released. Not thread-safe.
+     */
+    class MeshCache
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        MeshCache() = default;
+
+        MeshCache(const MeshCache&) = delete;
+
+        MeshCache(MeshCache&&) noexcept = default;
+
+        /**
+         * \brief Destroys all meshes that are still in the cache.
+         */
+        ~MeshCache() noexcept;
+
+        MeshCache& operator=(const MeshCache&) = delete;
+
+        MeshCache& operator=(MeshCache&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of distinct meshes in the cache.
+         * \return Number of meshes.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Meshes.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get a mesh with the given shape, generating it if it is not in the cache yet. Adds a reference.
+         * \param shape Shape.
+         * \param params Generator parameters.
+         * \return Mesh.
+         */
+        [[nodiscard]] sol::IMesh& acquire(const RectangleShape& shape, const Generator::Params& params);
+
+        /**
+         * \brief Get a mesh with the given shape, generating it if it is not in the cache yet. Adds a reference.
+         * \param shape Shape.
+         * \param params Generator parameters.
+         * \return Mesh.
+         */
+        [[nodiscard]] sol::IMesh& acquire(const CircleShape& shape, const Generator::Params& params);
+
+        /**
+         * \brief Release a reference to a mesh. Destroys the mesh if this was the last reference.
+         * \param mesh Mesh acquired from this cache or nullptr.
+         */
+        void release(const sol::IMesh* mesh);
+
+        /**
+         * \brief Replace a mesh with one with the given shape. The new mesh is acquired before the old one is
+         * released, so an unchanged mesh is not destroyed and regenerated.
+         * \tparam S Shape type.
+         * \param mesh Mesh acquired from this cache or nullptr. Updated to the new mesh.
+         * \param shape Shape.
+         * \param params Generator parameters.
+         * \return True if the mesh changed.
+         */
+        template<typename S>
+        bool replace(sol::IMesh*& mesh, const S& shape, const Generator::Params& params)
+        {
+            auto* old = mesh;
+            mesh      = &acquire(shape, params);
+            release(old);
+            return mesh != old;
+        }
+
+    private:
+        enum class Shape : uint32_t
+        {
+            Rectangle,
+            Circle
+        };
+
+        struct Key
+        {
+            Shape shape = Shape::Rectangle;
+
+            const sol::MeshManager* meshManager = nullptr;
+
+            /**
+             * \brief Bit patterns of the shape parameters, in a fixed order per shape (see toKeyValue).
+             */
+            std::array<uint32_t, 10> values{};
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept;
+        };
+
+        struct Entry
+        {
+            sol::IMesh* mesh = nullptr;
+
+            size_t references = 0;
+        };
+
+        /**
+         * \brief Get the bit pattern of a parameter. Zeros and NaNs are normalized, so that parameters that compare
+         * equal, or are both NaN, produce the same key.
+         * \param value Value.
+         * \return Bit pattern.
+         */
+        [[nodiscard]] static uint32_t toKeyValue(float value) noexcept;
+
+        template<typename G>
+        [[nodiscard]] sol::IMesh& acquire(const Key& key, G& generator, const Generator::Params& params);
+
+        std::unordered_map<Key, Entry, KeyHash> entries;
+
+        /**
+         * \brief Reverse lookup from mesh to key, used when releasing.
+         */
+        std::unordered_map<const sol::IMesh*, Key> keys;
+    };
+}  // namespace floah
@@ -0,0 +1,155 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <any>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/material/fwd.h"
+#include "sol/scenegraph/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/destruction_queue.h"
+
+namespace floah
+{
+    /**
+     * \brief Pool of the scenegraph nodes of destroyed widgets, so that new widgets of the same type can adopt and
+     * reconfigure them instead of creating new nodes. Pooled nodes stay linked into the scenegraph, but are disabled
+     * until they are adopted.
+     */
+    class NodePool
+    {
+    public:
+        static constexpr size_t default_capacity = 32;
+
+        /**
+         * \brief Nodes can only be adopted by widgets of the same type that use the same materials, because they are
+         * children of the shared material nodes of the panel.
+         */
+        struct Key
+        {
+            std::type_index type;
+
+            const sol::ForwardMaterialInstance* widgetMaterial = nullptr;
+
+            const sol::ForwardMaterialInstance* textMaterial = nullptr;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        /**
+         * \brief Nodes of a single widget.
+         */
+        struct Entry
+        {
+            /**
+             * \brief Widget specific structure with pointers to the nodes.
+             */
+            std::any nodes;
+
+            /**
+             * \brief Nodes that are not children of other nodes in the entry. These are disabled while pooled, and
+             * enabled again when they are adopted. The adopting widget sets the masks of roots that depend on its
+             * state.
+             */
+            std::vector<sol::Node*> roots;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        NodePool() = delete;
+
+        explicit NodePool(DestructionQueue& queue);
+
+        NodePool(const NodePool&) = delete;
+
+        NodePool(NodePool&&) noexcept = default;
+
+        /**
+         * \brief Queues all pooled nodes for destruction.
+         */
+        ~NodePool() noexcept;
+
+        NodePool& operator=(const NodePool&) = delete;
+
+        NodePool& operator=(NodePool&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the maximum number of entries that are pooled per key.
+         * \return Capacity.
+         */
+        [[nodiscard]] size_t getCapacity() const noexcept;
+
+        /**
+         * \brief Get the total number of pooled entries.
+         * \return Number of entries.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the maximum number of entries that are pooled per key. Entries above the capacity are queued for
+         * destruction.
+         * \param cap Capacity.
+         */
+        void setCapacity(size_t cap);
+
+        ////////////////////////////////////////////////////////////////
+        // Pool.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add the nodes of a destroyed widget to the pool. If the pool is full, the nodes are queued for
+         * destruction instead. The nodes must no longer refer to meshes of the widget.
+         * \param key Key.
+         * \param entry Entry.
+         */
+        void release(const Key& key, Entry entry);
+
+        /**
+         * \brief Take nodes from the pool.
+         * \param key Key.
+         * \param entry Receives the entry.
+         * \return True if an entry was found.
+         */
+        bool acquire(const Key& key, Entry& entry);
+
+        /**
+         * \brief Queue all pooled nodes for destruction.
+         */
+        void clear();
+
+    private:
+        struct KeyHash
+        {
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept;
+        };
+
+        DestructionQueue* destructionQueue = nullptr;
+
+        std::unordered_map<Key, std::vector<Entry>, KeyHash> entries;
+
+        size_t capacity = default_capacity;
+    };
+}  // namespace floah
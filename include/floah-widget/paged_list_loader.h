@@ -0,0 +1,179 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-data/i_list_data_source.h"
+
+namespace floah
+{
+    /**
+     * \brief Fetches the strings of a list data source in pages on a worker thread, so that slow sources do not block
+     * the thread that generates the widgets. Pages are requested and read on the owning thread. Pages that were fetched
+     * become readable after the next call to poll. The most recently requested page is fetched first. The number of
+     * fetched pages is capped. Above the cap, the pages farthest from the ranges requested before the last call to poll
+     * are dropped.
+     *
+     * The data source is read concurrently with the owning thread, so its getString and getSize methods must be
+     * thread-safe.
+     */
+    class PagedListLoader
+    {
+    public:
+        static constexpr size_t default_page_size = 32;
+
+        static constexpr size_t default_page_capacity = 16;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        PagedListLoader() = delete;
+
+        explicit PagedListLoader(const IListDataSource& dataSource, size_t size = default_page_size);
+
+        PagedListLoader(const PagedListLoader&) = delete;
+
+        PagedListLoader(PagedListLoader&&) noexcept = delete;
+
+        /**
+         * \brief Stops the worker thread, waiting for the page that is being fetched.
+         */
+        ~PagedListLoader() noexcept;
+
+        PagedListLoader& operator=(const PagedListLoader&) = delete;
+
+        PagedListLoader& operator=(PagedListLoader&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] const IListDataSource& getDataSource() const noexcept;
+
+        [[nodiscard]] size_t getPageSize() const noexcept;
+
+        /**
+         * \brief Get the maximum number of fetched pages that are kept.
+         * \return Capacity.
+         */
+        [[nodiscard]] size_t getPageCapacity() const noexcept;
+
+        /**
+         * \brief Get the string of an item, if its page was fetched.
+         * \param index Item index.
+         * \return String or nullptr if the page was not fetched yet. Valid until the next call to poll.
+         */
+        [[nodiscard]] const std::string* find(size_t index) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the maximum number of fetched pages that are kept. Pages above the capacity are dropped, farthest
+         * from the most recently requested ranges first.
+         * \param cap Capacity. Must be larger than 0.
+         */
+        void setPageCapacity(size_t cap);
+
+        ////////////////////////////////////////////////////////////////
+        // Loading.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Request the pages that contain a range of items. Pages that were fetched or requested before are
+         * skipped.
+         * \param first Index of first item.
+         * \param count Number of items.
+         */
+        void request(size_t first, size_t count);
+
+        /**
+         * \brief Make pages that were fetched since the last call readable.
+         * \return True if any pages were fetched.
+         */
+        bool poll();
+
+        /**
+         * \brief Drop all fetched and pending pages, e.g. after the data source changed. Pages that are being fetched
+         * are discarded when they arrive.
+         */
+        void invalidate();
+
+    private:
+        /**
+         * \brief Drop the pages farthest from the recent ranges until the capacity is no longer exceeded.
+         */
+        void evict();
+
+        void run(std::stop_token stop);
+
+        const IListDataSource* source = nullptr;
+
+        size_t pageSize = default_page_size;
+
+        size_t pageCapacity = default_page_capacity;
+
+        /**
+         * \brief First and last pages of the ranges requested since the last call to poll. Only accessed by the owning
+         * thread.
+         */
+        std::vector<std::pair<size_t, size_t>> requests;
+
+        /**
+         * \brief Ranges that were requested before the last call to poll that followed any requests. Pages in and near
+         * these ranges are kept when evicting. Only accessed by the owning thread.
+         */
+        std::vector<std::pair<size_t, size_t>> recent;
+
+        /**
+         * \brief Fetched pages by page index. Only accessed by the owning thread.
+         */
+        std::unordered_map<size_t, std::vector<std::string>> pages;
+
+        /**
+         * \brief Pages that were requested but did not arrive yet. Only accessed by the owning thread.
+         */
+        std::unordered_set<size_t> requested;
+
+        std::mutex mutex;
+
+        std::condition_variable_any condition;
+
+        /**
+         * \brief Pages waiting to be fetched by the worker. Guarded by mutex.
+         */
+        std::vector<size_t> queue;
+
+        /**
+         * \brief Pages fetched by the worker that were not polled yet. Guarded by mutex.
+         */
+        std::vector<std::pair<size_t, std::vector<std::string>>> arrived;
+
+        /**
+         * \brief Incremented by invalidate, so that pages fetched before are discarded. Guarded by mutex.
+         */
+        uint64_t generation = 0;
+
+        /**
+         * \brief Worker thread. Declared last, so that it is stopped before anything else is destroyed.
+         */
+        std::jthread worker;
+    };
+}  // namespace floah
@@ -5,6 +5,9 @@
 ////////////////////////////////////////////////////////////////
 
 #include <memory>
+#include <initializer_list>
+#include <ranges>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -23,13 +26,25 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-widget/batch_generator.h"
+#include "floah-widget/destruction_queue.h"
+#include "floah-widget/instance_batches.h"
 #include "floah-widget/layer.h"
+#include "floah-widget/mesh_cache.h"
+#include "floah-widget/node_pool.h"
+#include "floah-widget/slot_map.h"
+#include "floah-widget/static_batches.h"
+#include "floah-widget/style_cache.h"
+#include "floah-widget/style_key.h"
+#include "floah-widget/text_mesh_cache.h"
 #include "floah-widget/widgets/widget.h"
 
 namespace floah
 {
     class Panel : public InputElement
     {
+        friend class Widget;
+
     public:
         static constexpr char material_panel[] = "material.panel";
 
@@ -39,12 +54,34 @@ namespace floah
 
         enum class StaleData
         {
+            None       = 0,
             Layout     = 1,
             Geometry   = 2,
             Scenegraph = 4,
             All        = Layout | Geometry | Scenegraph
         };
 
+        /**
+         * \brief How widgets are processed during the generate stages that support concurrency.
+         */
+        enum class ExecutionMode
+        {
+            /**
+             * \brief Process widgets one after the other on the calling thread.
+             */
+            Serial,
+
+            /**
+             * \brief Process independent widgets concurrently. Results are identical to Serial. If the module was built
+             * without parallel algorithm support (libstdc++ without TBB), widgets are processed serially.
+             *
+             * Only widget layouts are generated concurrently (see Widget::generateLayout). The built-in widgets do not
+             * read data sources while generating their layout. Custom widgets that do require those data sources to be
+             * thread-safe, because widgets sharing a source read it from different threads.
+             */
+            Parallel
+        };
+
         ////////////////////////////////////////////////////////////////
         // Constructors.
         ////////////////////////////////////////////////////////////////
@@ -53,15 +90,23 @@ namespace floah
 
         explicit Panel(InputContext& context);
 
-        Panel(const Panel&) = default;
+        Panel(const Panel&) = delete;
 
-        Panel(Panel&&) noexcept = default;
+        /**
+         * \brief Widgets, pooled nodes and the destruction queue refer to the panel and each other by address, so a
+         * panel cannot be moved.
+         */
+        Panel(Panel&&) noexcept = delete;
 
+        /**
+         * \brief Calls release. Unless release was called before and the panel was not updated since, the scenegraph
+         * that contains the panel node and the mesh manager passed to update must still be alive.
+         */
         ~Panel() noexcept override;
 
-        Panel& operator=(const Panel&) = default;
+        Panel& operator=(const Panel&) = delete;
 
-        Panel& operator=(Panel&&) noexcept = default;
+        Panel& operator=(Panel&&) noexcept = delete;
 
         ////////////////////////////////////////////////////////////////
         // Getters.
@@ -107,15 +152,178 @@ namespace floah
 
         [[nodiscard]] virtual const sol::Node* getPanelNode() const noexcept;
 
+        /**
+         * \brief Get the material node for widget shapes that is shared by all widgets in this panel that use the
+         * given material. Created on first use.
+         * \param generator Scenegraph generator.
+         * \param material Material.
+         * \return Material node.
+         */
+        [[nodiscard]] sol::ForwardMaterialNode& getWidgetMaterialNode(IScenegraphGenerator&         generator,
+                                                                      sol::ForwardMaterialInstance* material);
+
+        /**
+         * \brief Get the material node for text that is shared by all widgets in this panel that use the given
+         * material. Created on first use.
+         * \param generator Scenegraph generator.
+         * \param material Material.
+         * \return Material node.
+         */
+        [[nodiscard]] sol::Node& getTextMaterialNode(IScenegraphGenerator&         generator,
+                                                     sol::ForwardMaterialInstance& material);
+
+        /**
+         * \brief Get the cache of meshes shared by the widgets in this panel.
+         * \return MeshCache.
+         */
+        [[nodiscard]] MeshCache& getMeshCache() noexcept;
+
+        /**
+         * \brief Get the cache of meshes shared by the widgets in this panel.
+         * \return MeshCache.
+         */
+        [[nodiscard]] const MeshCache& getMeshCache() const noexcept;
+
+        /**
+         * \brief Get the cache of text meshes used by the widgets in this panel. Can be shared with other panels.
+         * \return TextMeshCache.
+         */
+        [[nodiscard]] TextMeshCache& getTextMeshCache() noexcept;
+
+        /**
+         * \brief Get the cache of text meshes used by the widgets in this panel. Can be shared with other panels.
+         * \return TextMeshCache.
+         */
+        [[nodiscard]] const TextMeshCache& getTextMeshCache() const noexcept;
+
+        /**
+         * \brief Get the instance batches of the widgets that are drawn instanced.
+         * \return InstanceBatches.
+         */
+        [[nodiscard]] const InstanceBatches& getInstanceBatches() const noexcept;
+
+        /**
+         * \brief Get whether widgets that support it draw their shapes through instance batches instead of nodes.
+         * \return True if instancing is enabled.
+         */
+        [[nodiscard]] bool isInstancingEnabled() const noexcept;
+
+        /**
+         * \brief Get the static batches of the widgets that batch their static shapes.
+         * \return StaticBatches.
+         */
+        [[nodiscard]] const StaticBatches& getStaticBatches() const noexcept;
+
+        /**
+         * \brief Get whether widgets put their static shapes into static batches instead of nodes.
+         * \return True if batching is enabled.
+         */
+        [[nodiscard]] bool isBatchingEnabled() const noexcept;
+
+        /**
+         * \brief Get the generator that turns the batches of this panel into meshes and nodes.
+         * \return IBatchGenerator or nullptr.
+         */
+        [[nodiscard]] IBatchGenerator* getBatchGenerator() const noexcept;
+
+        /**
+         * \brief Get the pool of scenegraph nodes of destroyed widgets, which new widgets of the same type adopt.
+         * \return NodePool.
+         */
+        [[nodiscard]] NodePool& getNodePool() noexcept;
+
+        /**
+         * \brief Get the pool of scenegraph nodes of destroyed widgets, which new widgets of the same type adopt.
+         * \return NodePool.
+         */
+        [[nodiscard]] const NodePool& getNodePool() const noexcept;
+
+        /**
+         * \brief Get the panel data that is stale and needs to be regenerated.
+         * \return StaleData.
+         */
+        [[nodiscard]] StaleData getStaleData() const noexcept;
+
+        /**
+         * \brief Get the execution mode of the generate stages.
+         * \return ExecutionMode.
+         */
+        [[nodiscard]] ExecutionMode getExecutionMode() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief Set the panel stylesheet.
+         * \brief Set the panel stylesheet. If the stylesheet is different, the panel and all widgets become stale.
          * \param sheet Stylesheet or nullptr.
          */
-        void setStylesheet(Stylesheet* sheet) noexcept;
+        void setStylesheet(Stylesheet* sheet);
+
+        /**
+         * \brief Notify the panel that properties of a stylesheet were modified in place. Only widgets that read the
+         * stylesheet are affected, and only the data that depends on the changed properties is marked as stale (see
+         * Widget::getStyleDependency).
+         * \param sheet Modified stylesheet. Either the panel stylesheet or a widget stylesheet.
+         * \param keys Keys of the modified properties.
+         */
+        void notifyStylesheetChanged(const Stylesheet& sheet, std::span<const StyleKey> keys);
+
+        /**
+         * \brief Notify the panel that properties of a stylesheet were modified in place.
+         * \param sheet Modified stylesheet. Either the panel stylesheet or a widget stylesheet.
+         * \param keys Keys of the modified properties.
+         */
+        void notifyStylesheetChanged(const Stylesheet& sheet, const std::initializer_list<StyleKey> keys)
+        {
+            notifyStylesheetChanged(sheet, std::span(keys.begin(), keys.end()));
+        }
+
+        /**
+         * \brief Set the cache of text meshes, e.g. to share it with other panels. Must be called before adding
+         * widgets.
+         * \param cache Cache.
+         */
+        void setTextMeshCache(std::shared_ptr<TextMeshCache> cache);
+
+        /**
+         * \brief Enable or disable instancing. If enabled, widgets that support it do not create nodes for their
+         * shapes, but keep instances in the instance batches of this panel up to date instead. The batch generator
+         * creates a node for each batch that draws it with one instanced draw, which the panel puts under the material
+         * node of the batch. Requires a batch generator. Must be called before adding widgets.
+         * \param enabled Enabled.
+         */
+        void setInstancingEnabled(bool enabled);
+
+        /**
+         * \brief Enable or disable batching. If enabled, widgets do not create meshes or nodes for their static shapes,
+         * such as boxes and outlines, but keep a sub-range in the static batch of their material and layer up to date
+         * instead. The batch generator uploads the merged vertices of each batch into one mesh, which the panel puts
+         * into a single node under the material node of the batch. Shapes that are instanced are not batched. Requires
+         * a batch generator. Must be called before adding widgets.
+         * \param enabled Enabled.
+         */
+        void setBatchingEnabled(bool enabled);
+
+        /**
+         * \brief Set the generator that turns the batches of this panel into meshes and nodes. Batching and instancing
+         * are disabled if the generator is removed. Must be called before adding widgets.
+         * \param generator Generator or nullptr. Must outlive the panel or be replaced before it is destroyed.
+         */
+        void setBatchGenerator(IBatchGenerator* generator);
+
+        /**
+         * \brief Mark panel data as stale. Must be called after modifying the panel layout tree. Changes to the size
+         * or offset of the panel layout are detected automatically by update.
+         * \param data Stale data.
+         */
+        void markStale(StaleData data) noexcept;
+
+        /**
+         * \brief Set the execution mode of the generate stages.
+         * \param mode ExecutionMode.
+         */
+        void setExecutionMode(ExecutionMode mode) noexcept;
 
         ////////////////////////////////////////////////////////////////
         // Layers.
@@ -175,28 +383,87 @@ namespace floah
             return ref;
         }
 
+        /**
+         * \brief Add multiple widgets to this panel at once. Storage is reserved once for all widgets.
+         * \tparam R Range of std::unique_ptr<T>.
+         * \param range Widgets. Widgets are moved out of the range.
+         * \return List of widgets.
+         */
+        template<std::ranges::input_range R>
+            requires(std::derived_from<typename std::ranges::range_value_t<R>::element_type, Widget>)
+        auto addWidgets(R&& range)
+        {
+            return addWidgetsImpl(std::forward<R>(range), nullptr);
+        }
+
+        /**
+         * \brief Add multiple widgets to this panel at once. Storage is reserved once for all widgets.
+         * \tparam R Range of std::unique_ptr<T>.
+         * \param range Widgets. Widgets are moved out of the range.
+         * \param layer Layer to add widgets to.
+         * \return List of widgets.
+         */
+        template<std::ranges::input_range R>
+            requires(std::derived_from<typename std::ranges::range_value_t<R>::element_type, Widget>)
+        auto addWidgets(R&& range, Layer& layer)
+        {
+            return addWidgetsImpl(std::forward<R>(range), &layer);
+        }
+
+        /**
+         * \brief Retrieve a widget by handle.
+         * \param handle Widget handle.
+         * \return Widget or nullptr if the widget was destroyed.
+         */
+        [[nodiscard]] Widget* getWidget(WidgetHandle handle) noexcept;
+
+        /**
+         * \brief Retrieve a widget by handle.
+         * \param handle Widget handle.
+         * \return Widget or nullptr if the widget was destroyed.
+         */
+        [[nodiscard]] const Widget* getWidget(WidgetHandle handle) const noexcept;
+
         /**
          * \brief Destroy a widget, completely removing it from this panel.
          * \param widget Widget.
          */
         void destroyWidget(Widget& widget);
 
+        /**
+         * \brief Destroy all widgets, detach all nodes this panel added to the scenegraph and destroy the meshes of the
+         * widgets. Afterwards, the panel no longer refers to the scenegraph or the mesh manager, so that those can be
+         * destroyed before the panel. New widgets can be added and generated with the next update.
+         */
+        void release();
+
         ////////////////////////////////////////////////////////////////
         // Generate.
         ////////////////////////////////////////////////////////////////
 
         /**
-         * \brief Generate the panel layout.
+         * \brief Poll all widgets that enabled polling and then run all generate stages that have stale data, in order.
+         * Finally destroys the nodes and meshes of widgets that were destroyed since the last update.
+         * \param meshManager Mesh manager.
+         * \param fontMap Font map.
+         * \param generator Scenegraph generator.
+         */
+        void update(sol::MeshManager& meshManager, FontMap& fontMap, IScenegraphGenerator& generator);
+
+        /**
+         * \brief Generate the panel layout. Widgets attached to elements whose block was added or changed are marked
+         * as stale.
          */
         virtual void generatePanelLayout();
 
         /**
-         * \brief Generate the widget layouts.
+         * \brief Generate the widget layouts. Runs concurrently if the execution mode is Parallel. In both modes, an
+         * exception thrown by a widget is propagated to the caller, and all widgets stay queued.
          */
         virtual void generateWidgetLayouts();
 
         /**
-         * \brief Generate the geometry.
+         * \brief Generate the geometry. Always runs serially, regardless of the execution mode.
          */
         virtual void generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap);
 
@@ -217,13 +484,106 @@ namespace floah
     private:
         void addWidgetImpl(WidgetPtr widget, Layer* layer);
 
+        template<typename R>
+        auto addWidgetsImpl(R&& range, Layer* layer)
+        {
+            using T = typename std::ranges::range_value_t<R>::element_type;
+
+            std::vector<WidgetPtr> ws;
+            std::vector<T*>        refs;
+            if constexpr (std::ranges::sized_range<R>)
+            {
+                ws.reserve(std::ranges::size(range));
+                refs.reserve(std::ranges::size(range));
+            }
+
+            for (auto&& w : range)
+            {
+                refs.push_back(w.get());
+                ws.emplace_back(std::move(w));
+            }
+
+            addWidgetsImpl(std::move(ws), layer);
+            return refs;
+        }
+
+        void addWidgetsImpl(std::vector<WidgetPtr> ws, Layer* layer);
+
+        /**
+         * \brief Add widget to the work queues of all stages it is stale for and not yet queued in.
+         * \param widget Widget.
+         */
+        void enqueueStaleWidget(Widget& widget);
+
+        /**
+         * \brief Take all widgets from a work queue that are still stale for the given stage.
+         * \param queue Work queue.
+         * \param stage Stage.
+         * \return List of widgets.
+         */
+        [[nodiscard]] std::vector<Widget*> takeStaleWidgets(std::vector<WidgetHandle>& queue, Widget::StaleData stage);
+
+        /**
+         * \brief Add widgets taken from the work queues back to the queues of the stages they are still stale for,
+         * e.g. after a generate call threw before all of them were processed.
+         * \param ws Widgets.
+         */
+        void requeueStaleWidgets(std::span<Widget* const> ws);
+
+        /**
+         * \brief Generate the layouts of widgets taken from the layout work queue.
+         * \param ws Widgets.
+         */
+        void generateWidgetLayoutsImpl(std::span<Widget* const> ws);
+
+        /**
+         * \brief Create or update the nodes of every static and instance batch, and queue those of empty batches for
+         * destruction.
+         * \param generator Scenegraph generator.
+         */
+        void generateBatchNodes(IScenegraphGenerator& generator);
+
+        /**
+         * \brief Destroy the empty static and instance batches and queue their meshes and nodes for destruction.
+         */
+        void destroyEmptyBatches();
+
     protected:
+        /**
+         * \brief Find the panel layout block generated for an element.
+         * \param element Element.
+         * \return Block or nullptr if the element has no block.
+         */
+        [[nodiscard]] const Block* findBlock(const LayoutElement& element) const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Stylesheet getter.
         ////////////////////////////////////////////////////////////////
         
+        /**
+         * \brief Get a property from the panel stylesheet. Lookups are cached by key hash.
+         * \tparam T Property type.
+         * \param key Property key.
+         * \return Property value or empty.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> getStylesheetProperty(const StyleKey key) const
+        {
+            if (stylesheet) return styleCache.get<T>(*stylesheet, key);
+            return {};
+        }
+
+        /**
+         * \brief Get a property from the panel stylesheet. Constant character arrays are converted to a StyleKey
+         * instead.
+         * \tparam T Property type.
+         * \tparam N Name type.
+         * \param name Property name.
+         * \return Property value or empty.
+         */
         template<typename T, typename N>
-        [[nodiscard]] std::optional<T> getStylesheetProperty(N name) const
+            requires(!std::is_array_v<std::remove_cvref_t<N>> && !std::same_as<std::remove_cvref_t<N>, StyleKey>)
+        [[nodiscard]] std::optional<T> getStylesheetProperty(N&& name) const
         {
             // Try to retrieve property from stylesheet.
             if (stylesheet)
@@ -249,16 +609,99 @@ namespace floah
          */
         std::unordered_map<std::string, std::unique_ptr<Layer>> layers;
 
+        /**
+         * \brief Meshes shared by widgets. Declared before the widgets, so that it outlives them.
+         */
+        MeshCache meshCache;
+
+        /**
+         * \brief Text meshes used by widgets. Declared before the widgets, so that it outlives them.
+         */
+        std::shared_ptr<TextMeshCache> textMeshCache;
+
+        /**
+         * \brief Instanced widget shapes. Declared before the widgets, so that it outlives them.
+         */
+        InstanceBatches instanceBatches;
+
+        /**
+         * \brief Batched static widget shapes. Declared before the widgets, so that it outlives them.
+         */
+        StaticBatches staticBatches;
+
+        /**
+         * \brief Nodes and meshes of destroyed widgets. Flushed once per update. Declared after the caches, so that it
+         * can release meshes when the panel is destroyed, and before the widgets, so that it outlives them.
+         */
+        DestructionQueue destructionQueue;
+
+        /**
+         * \brief Nodes of destroyed widgets. Declared after the destruction queue, which it puts nodes in that are not
+         * pooled, and before the widgets, so that it outlives them.
+         */
+        NodePool nodePool;
+
         /**
          * \brief List of widgets in this panel.
          */
-        std::vector<WidgetPtr> widgets;
+        SlotMap<WidgetPtr> widgets;
+
+        /**
+         * \brief Work queues of widgets that have stale data, per stage.
+         */
+        struct
+        {
+            std::vector<WidgetHandle> layout;
+            std::vector<WidgetHandle> geometry;
+            std::vector<WidgetHandle> scenegraph;
+        } staleWidgets;
+
+        /**
+         * \brief Widgets that are polled by update. May contain handles of destroyed widgets or widgets that disabled
+         * polling, which are removed when polling.
+         */
+        std::vector<WidgetHandle> pollingWidgets;
 
         /**
          * \brief Layout blocks.
          */
         std::vector<Block> blocks;
 
+        /**
+         * \brief Index into blocks by element id. Rebuilt whenever the panel layout is generated.
+         */
+        std::unordered_map<decltype(Block::id), size_t> blockIndex;
+
+        /**
+         * \brief Material nodes shared by the widgets, so that each material is bound once instead of once per widget.
+         * The root is detached, together with all material nodes, when the panel is destroyed.
+         */
+        struct
+        {
+            sol::Node*                                                                         root = nullptr;
+            std::unordered_map<const sol::ForwardMaterialInstance*, sol::ForwardMaterialNode*> widget;
+            std::unordered_map<const sol::ForwardMaterialInstance*, sol::Node*>                text;
+        } materialNodes;
+
+        /**
+         * \brief Mesh and node of a static batch. The node is a child of the material node of the batch.
+         */
+        struct StaticBatchNode
+        {
+            sol::IMesh*    mesh = nullptr;
+            sol::MeshNode* node = nullptr;
+        };
+
+        /**
+         * \brief Meshes and nodes of the static batches, by batch.
+         */
+        std::unordered_map<const StaticBatch*, StaticBatchNode> staticBatchNodes;
+
+        /**
+         * \brief Nodes of the instance batches, by batch. Each node is a child of the material node of its batch.
+         */
+        std::unordered_map<const InstanceBatch*, sol::Node*> instanceBatchNodes;
+
         /**
          * \brief Input context.
          */
@@ -269,6 +712,28 @@ namespace floah
          */
         Stylesheet* stylesheet = nullptr;
 
+        /**
+         * \brief Cached stylesheet lookups of the panel and its widgets.
+         */
+        mutable StyleCache styleCache;
+
         StaleData staleData = StaleData::All;
+
+        ExecutionMode executionMode = ExecutionMode::Serial;
+
+        bool instancing = false;
+
+        bool batching = false;
+
+        IBatchGenerator* batchGenerator = nullptr;
+
+        /**
+         * \brief Size and offset of the panel layout at the time it was last generated.
+         */
+        struct
+        {
+            Size size;
+            Size offset;
+        } generatedLayout;
     };
 }  // namespace floah
@@ -0,0 +1,180 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Handle to a value in a SlotMap. Remains valid until the value is erased. Handles of erased values never
+     * resolve to a value inserted later on.
+     */
+    struct SlotMapHandle
+    {
+        static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index = invalid_index;
+
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const noexcept { return index != invalid_index; }
+
+        [[nodiscard]] bool operator==(const SlotMapHandle&) const noexcept = default;
+    };
+
+    /**
+     * \brief Container with O(1) insertion, erasure and lookup through generational handles. Values are stored densely
+     * and can be iterated over like a vector. Erasure moves the last value into the erased position, so iteration order
+     * is not stable.
+     * \tparam T Value type.
+     */
+    template<typename T>
+    class SlotMap
+    {
+    public:
+        using Handle         = SlotMapHandle;
+        using iterator       = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] size_t size() const noexcept { return values.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return values.empty(); }
+
+        [[nodiscard]] bool contains(const Handle handle) const noexcept { return find(handle) != nullptr; }
+
+        /**
+         * \brief Get the value a handle refers to.
+         * \param handle Handle.
+         * \return Pointer to value or nullptr if the handle is invalid or its value was erased.
+         */
+        [[nodiscard]] T* find(const Handle handle) noexcept
+        {
+            if (handle.index >= slots.size()) return nullptr;
+            const auto& slot = slots[handle.index];
+            if (slot.generation != handle.generation || !slot.occupied) return nullptr;
+            return &values[slot.dense];
+        }
+
+        /**
+         * \brief Get the value a handle refers to.
+         * \param handle Handle.
+         * \return Pointer to value or nullptr if the handle is invalid or its value was erased.
+         */
+        [[nodiscard]] const T* find(const Handle handle) const noexcept
+        {
+            return const_cast<SlotMap*>(this)->find(handle);
+        }
+
+        [[nodiscard]] iterator begin() noexcept { return values.begin(); }
+
+        [[nodiscard]] iterator end() noexcept { return values.end(); }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return values.begin(); }
+
+        [[nodiscard]] const_iterator end() const noexcept { return values.end(); }
+
+        ////////////////////////////////////////////////////////////////
+        // Modifiers.
+        ////////////////////////////////////////////////////////////////
+
+        void reserve(const size_t count)
+        {
+            values.reserve(count);
+            denseToSlot.reserve(count);
+            slots.reserve(count);
+        }
+
+        /**
+         * \brief Insert a value.
+         * \param value Value.
+         * \return Handle to value.
+         */
+        Handle insert(T value)
+        {
+            uint32_t index;
+            if (freeHead != Handle::invalid_index)
+            {
+                index    = freeHead;
+                freeHead = slots[index].dense;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(slots.size());
+                slots.emplace_back();
+            }
+
+            auto& slot    = slots[index];
+            slot.dense    = static_cast<uint32_t>(values.size());
+            slot.occupied = true;
+            values.emplace_back(std::move(value));
+            denseToSlot.push_back(index);
+
+            return {.index = index, .generation = slot.generation};
+        }
+
+        /**
+         * \brief Erase the value a handle refers to.
+         * \param handle Handle.
+         * \return True if a value was erased, false if the handle was invalid.
+         */
+        bool erase(const Handle handle)
+        {
+            if (!contains(handle)) return false;
+
+            auto&          slot = slots[handle.index];
+            const uint32_t last = static_cast<uint32_t>(values.size() - 1);
+
+            // Keep erased value alive until the bookkeeping is consistent again, in case its destructor accesses us.
+            [[maybe_unused]] T erased = std::move(values[slot.dense]);
+
+            // Move last value into erased position.
+            if (slot.dense != last)
+            {
+                values[slot.dense]             = std::move(values[last]);
+                denseToSlot[slot.dense]        = denseToSlot[last];
+                slots[denseToSlot[last]].dense = slot.dense;
+            }
+            values.pop_back();
+            denseToSlot.pop_back();
+
+            // Invalidate all handles to this slot and add it to the free list.
+            slot.generation++;
+            slot.occupied = false;
+            slot.dense    = freeHead;
+            freeHead      = handle.index;
+
+            return true;
+        }
+
+    private:
+        struct Slot
+        {
+            uint32_t generation = 0;
+
+            /**
+             * \brief Index into values if occupied, otherwise next free slot.
+             */
+            uint32_t dense = Handle::invalid_index;
+
+            bool occupied = false;
+        };
+
+        std::vector<T> values;
+
+        std::vector<uint32_t> denseToSlot;
+
+        std::vector<Slot> slots;
+
+        uint32_t freeHead = Handle::invalid_index;
+    };
+}  // namespace floah
@@ -0,0 +1,268 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+#include "sol/material/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/mesh_cache.h"
+#include "floah-widget/slot_map.h"
+
+namespace floah
+{
+    class StaticBatch;
+
+    /**
+     * \brief Static widget shape that is part of a StaticBatch.
+     */
+    struct StaticGeometry
+    {
+        /**
+         * \brief Shape, which is centered around the origin.
+         */
+        RectangleShape shape;
+
+        /**
+         * \brief Offset that is added to the vertices of the shape when merging it into the batch.
+         */
+        math::float3 offset;
+    };
+
+    /**
+     * \brief Sub-range of the merged vertices of a StaticBatch.
+     */
+    struct StaticSubRange
+    {
+        StaticGeometry geometry;
+
+        /**
+         * \brief Index of the first vertex of this sub-range in the merged vertices.
+         */
+        size_t firstVertex = 0;
+
+        size_t vertexCount = 0;
+    };
+
+    /**
+     * \brief Vertex of the merged geometry of a StaticBatch. Triangles are stored as a list, without indices.
+     */
+    struct StaticVertex
+    {
+        math::float3 position;
+
+        math::float4 color;
+    };
+
+    /**
+     * \brief Handle to a sub-range in a StaticBatch.
+     */
+    struct StaticGeometryHandle
+    {
+        StaticBatch* batch = nullptr;
+
+        SlotMapHandle handle;
+
+        [[nodiscard]] bool valid() const noexcept { return batch != nullptr; }
+    };
+
+    /**
+     * \brief Static geometry of all widgets on a layer that use the same material. The sub-ranges are merged into a
+     * single list of vertices, which the IBatchGenerator of the panel uploads into one mesh. Only the vertices in the
+     * dirty range need to be uploaded again.
+     */
+    class StaticBatch
+    {
+        friend class StaticBatches;
+
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        StaticBatch() = delete;
+
+        StaticBatch(sol::ForwardMaterialInstance* batchMaterial, int32_t batchLayer);
+
+        StaticBatch(const StaticBatch&) = delete;
+
+        StaticBatch(StaticBatch&&) noexcept = delete;
+
+        ~StaticBatch() noexcept = default;
+
+        StaticBatch& operator=(const StaticBatch&) = delete;
+
+        StaticBatch& operator=(StaticBatch&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        [[nodiscard]] sol::ForwardMaterialInstance* getMaterial() const noexcept;
+
+        [[nodiscard]] int32_t getLayer() const noexcept;
+
+        /**
+         * \brief Get the sub-ranges of this batch, in the order they are merged. Their order changes when sub-ranges
+         * are removed.
+         * \return Sub-ranges.
+         */
+        [[nodiscard]] std::span<const StaticSubRange> getSubRanges() const noexcept;
+
+        /**
+         * \brief Get the merged vertices of all sub-ranges.
+         * \return Vertices.
+         */
+        [[nodiscard]] std::span<const StaticVertex> getVertices() const noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * \brief Get the range of vertices that were modified or moved since the dirty range was last cleared. The
+         * range can extend past the end of the vertices if the batch shrank, in which case the mesh must be truncated.
+         * \return Index of first and one past the last modified vertex. Empty if nothing was modified.
+         */
+        [[nodiscard]] std::pair<size_t, size_t> getDirtyRange() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clear the dirty range, e.g. after uploading the modified vertices.
+         */
+        void clearDirtyRange() noexcept;
+
+    private:
+        SlotMapHandle add(const StaticGeometry& geometry);
+
+        void update(StaticSubRange& subRange, const StaticGeometry& geometry);
+
+        void erase(SlotMapHandle handle);
+
+        /**
+         * \brief Regenerate the vertices of all sub-ranges from the given index onwards, e.g. because a sub-range
+         * before them changed its number of vertices.
+         * \param index Index of first sub-range.
+         */
+        void rebuild(size_t index);
+
+        void markDirty(size_t first, size_t last) noexcept;
+
+        sol::ForwardMaterialInstance* material = nullptr;
+
+        int32_t layer = 0;
+
+        SlotMap<StaticSubRange> subRanges;
+
+        std::vector<StaticVertex> vertices;
+
+        std::pair<size_t, size_t> dirty;
+    };
+
+    /**
+     * \brief Static batches of the widgets in a panel. Widgets that batch their static shapes do not create meshes or
+     * nodes for them, but keep a sub-range in the batch of their material and layer up to date instead. The panel
+     * turns each batch into a single mesh node.
+     */
+    class StaticBatches
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        StaticBatches() = default;
+
+        StaticBatches(const StaticBatches&) = delete;
+
+        StaticBatches(StaticBatches&&) noexcept = default;
+
+        ~StaticBatches() noexcept = default;
+
+        StaticBatches& operator=(const StaticBatches&) = delete;
+
+        StaticBatches& operator=(StaticBatches&&) noexcept = default;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all batches. Batches whose last sub-range was removed are kept until they are taken by
+         * takeEmpty.
+         * \return Batches.
+         */
+        [[nodiscard]] const std::vector<std::unique_ptr<StaticBatch>>& getBatches() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Geometry.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Add or update a sub-range, moving it to another batch if the material or layer changed. Does not mark
+         * any vertices as dirty if nothing changed.
+         * \param handle Handle or invalid handle, in which case a new sub-range is added. Updated to the new sub-range.
+         * \param material Material.
+         * \param layer Layer.
+         * \param geometry Geometry.
+         */
+        void replace(StaticGeometryHandle&         handle,
+                     sol::ForwardMaterialInstance* material,
+                     int32_t                       layer,
+                     const StaticGeometry&         geometry);
+
+        /**
+         * \brief Remove a sub-range.
+         * \param handle Handle or invalid handle. Reset to an invalid handle.
+         */
+        void remove(StaticGeometryHandle& handle);
+
+        /**
+         * \brief Take all batches without sub-ranges out of this object, e.g. to destroy the meshes and nodes that
+         * were created for them before destroying the batches themselves.
+         * \return Empty batches.
+         */
+        [[nodiscard]] std::vector<std::unique_ptr<StaticBatch>> takeEmpty();
+
+    private:
+        struct Key
+        {
+            const sol::ForwardMaterialInstance* material = nullptr;
+
+            int32_t layer = 0;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept;
+        };
+
+        [[nodiscard]] static bool equal(const StaticGeometry& lhs, const StaticGeometry& rhs) noexcept;
+
+        std::vector<std::unique_ptr<StaticBatch>> batches;
+
+        /**
+         * \brief Index into batches by key.
+         */
+        std::unordered_map<Key, size_t, KeyHash> batchIndex;
+    };
+}  // namespace floah
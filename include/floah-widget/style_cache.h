@@ -0,0 +1,147 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-layout/layout.h"
+#include "floah-viz/stylesheet.h"
+#include "math/include_all.h"
+#include "sol/material/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/style_key.h"
+
+namespace floah
+{
+    /**
+     * \brief Memoizes stylesheet lookups by stylesheet and key hash, so that repeated lookups of the same property do
+     * not hash and compare strings again. Values are stored inline, typed by the property types widgets read. Not
+     * thread-safe.
+     */
+    class StyleCache
+    {
+        using Value = std::variant<std::optional<Length>,
+                                   std::optional<Size>,
+                                   std::optional<Margin>,
+                                   std::optional<size_t>,
+                                   std::optional<math::float4>,
+                                   std::optional<sol::ForwardMaterialInstance*>>;
+
+    public:
+        /**
+         * \brief Whether properties of type T can be cached.
+         */
+        template<typename T>
+        static constexpr bool is_cacheable = []<typename... Ts>(const std::variant<Ts...>*) {
+            return (std::same_as<std::optional<T>, Ts> || ...);
+        }(static_cast<const Value*>(nullptr));
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get a property from a stylesheet. A property that was cached as a different type before is looked up
+         * without the cache.
+         * \tparam T Property type.
+         * \param sheet Stylesheet.
+         * \param key Property key.
+         * \return Property value or empty if the stylesheet does not have it.
+         */
+        template<typename T>
+            requires(is_cacheable<T>)
+        [[nodiscard]] std::optional<T> get(const Stylesheet& sheet, const StyleKey key)
+        {
+            const Key k{.sheet = &sheet, .hash = key.getHash()};
+            auto      it = entries.find(k);
+            if (it == entries.end())
+            {
+                auto value = sheet.get<T>(std::string(key.getName()));
+                it         = entries.try_emplace(k, std::in_place_type<std::optional<T>>, std::move(value)).first;
+            }
+
+            const auto* value = std::get_if<std::optional<T>>(&it->second);
+            if (!value) return sheet.get<T>(std::string(key.getName()));
+
+            return *value;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Invalidation.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Remove all cached properties of a stylesheet.
+         * \param sheet Stylesheet.
+         */
+        void invalidate(const Stylesheet* sheet)
+        {
+            if (!sheet) return;
+            std::erase_if(entries, [sheet](const auto& entry) { return entry.first.sheet == sheet; });
+        }
+
+        /**
+         * \brief Remove all cached properties of several stylesheets, in a single pass over the cache.
+         * \param sheets Stylesheets. May contain nullptr.
+         */
+        void invalidate(const std::span<const Stylesheet* const> sheets)
+        {
+            if (sheets.empty()) return;
+            std::erase_if(entries, [sheets](const auto& entry) {
+                return std::ranges::find(sheets, entry.first.sheet) != sheets.end();
+            });
+        }
+
+        /**
+         * \brief Remove the cached properties of a stylesheet with the given keys.
+         * \param sheet Stylesheet.
+         * \param keys Property keys.
+         */
+        void invalidate(const Stylesheet& sheet, const std::span<const StyleKey> keys)
+        {
+            for (const auto key : keys) entries.erase(Key{.sheet = &sheet, .hash = key.getHash()});
+        }
+
+        /**
+         * \brief Remove all cached properties.
+         */
+        void clear() noexcept { entries.clear(); }
+
+    private:
+        struct Key
+        {
+            const Stylesheet* sheet = nullptr;
+
+            uint64_t hash = 0;
+
+            [[nodiscard]] bool operator==(const Key&) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept
+            {
+                return static_cast<size_t>(key.hash ^ (reinterpret_cast<uintptr_t>(key.sheet) * 0x9E3779B97F4A7C15ull));
+            }
+        };
+
+        std::unordered_map<Key, Value, KeyHash> entries;
+    };
+}  // namespace floah
@@ -0,0 +1,76 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string_view>
+
+namespace floah
+{
+    /**
+     * \brief Stylesheet property name with a hash that is computed at compile time. Can be implicitly constructed from
+     * a constant character array, such as the static property names of widgets or a string literal. Names that are only
+     * known at runtime, e.g. read from a theme file, are hashed when the key is constructed.
+     */
+    class StyleKey
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        StyleKey() = delete;
+
+        template<size_t N>
+        consteval StyleKey(const char (&str)[N]) noexcept : name(str, N - 1), hash(calculateHash(name))
+        {
+        }
+
+        /**
+         * \brief Construct a key from a property name. The key refers to the name, which must outlive it.
+         * \param str Name.
+         */
+        constexpr explicit StyleKey(const std::string_view str) noexcept : name(str), hash(calculateHash(str)) {}
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the property name.
+         * \return Name.
+         */
+        [[nodiscard]] constexpr std::string_view getName() const noexcept { return name; }
+
+        /**
+         * \brief Get the hash of the property name.
+         * \return Hash.
+         */
+        [[nodiscard]] constexpr uint64_t getHash() const noexcept { return hash; }
+
+        [[nodiscard]] constexpr bool operator==(const StyleKey& other) const noexcept { return hash == other.hash; }
+
+        /**
+         * \brief Calculate the 64-bit FNV-1a hash of a property name.
+         * \param str Name.
+         * \return Hash.
+         */
+        [[nodiscard]] static constexpr uint64_t calculateHash(const std::string_view str) noexcept
+        {
+            uint64_t h = 14695981039346656037ull;
+            for (const char c : str)
+            {
+                h ^= static_cast<uint8_t>(c);
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+
+    private:
+        std::string_view name;
+
+        uint64_t hash;
+    };
+}  // namespace floah
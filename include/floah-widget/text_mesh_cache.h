@@ -0,0 +1,211 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+#include "floah-viz/generators/generator.h"
+#include "floah-viz/generators/text_generator.h"
+#include "sol/mesh/fwd.h"
+
+namespace floah
+{
+    /**
+     * \brief Cache of generated text meshes, keyed by string, font map and mesh manager. Meshes are reference counted,
+     * so that repeated strings are shaped and uploaded once. Meshes that are no longer referenced are kept around and
+     * evicted in least recently used order once the estimated memory usage exceeds the cap. Can be shared by multiple
+     * panels. Not thread-safe.
+     */
+    class TextMeshCache
+    {
+    public:
+        /**
+         * \brief Estimated size in bytes of the mesh data generated for a single character.
+         */
+        static constexpr size_t estimated_character_size = 128;
+
+        static constexpr size_t default_memory_cap = 4 * 1024 * 1024;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        TextMeshCache() = default;
+
+        explicit TextMeshCache(size_t cap);
+
+        TextMeshCache(const TextMeshCache&) = delete;
+
+        TextMeshCache(TextMeshCache&&) noexcept = delete;
+
+        /**
+         * \brief Destroys all meshes that are still in the cache.
+         */
+        ~TextMeshCache() noexcept;
+
+        TextMeshCache& operator=(const TextMeshCache&) = delete;
+
+        TextMeshCache& operator=(TextMeshCache&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of meshes in the cache, including unreferenced meshes.
+         * \return Number of meshes.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * \brief Get the estimated memory usage of all meshes in the cache.
+         * \return Size in bytes.
+         */
+        [[nodiscard]] size_t getMemoryUsage() const noexcept;
+
+        /**
+         * \brief Get the memory cap above which unreferenced meshes are evicted.
+         * \return Size in bytes.
+         */
+        [[nodiscard]] size_t getMemoryCap() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the memory cap above which unreferenced meshes are evicted. Referenced meshes are never evicted,
+         * so usage can exceed the cap.
+         * \param cap Size in bytes.
+         */
+        void setMemoryCap(size_t cap);
+
+        ////////////////////////////////////////////////////////////////
+        // Meshes.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get a mesh for the given text, generating it if it is not in the cache yet. Adds a reference.
+         * \param generator Generator.
+         * \param params Generator parameters.
+         * \return Mesh.
+         */
+        [[nodiscard]] sol::IMesh& acquire(TextGenerator& generator, const Generator::Params& params);
+
+        /**
+         * \brief Release a reference to a mesh. The mesh is kept in the cache until it is evicted.
+         * \param mesh Mesh acquired from this cache or nullptr.
+         */
+        void release(const sol::IMesh* mesh);
+
+        /**
+         * \brief Replace a mesh with one for the given text. The new mesh is acquired before the old one is released,
+         * so unchanged text is not regenerated.
+         * \param mesh Mesh acquired from this cache or nullptr. Updated to the new mesh.
+         * \param generator Generator.
+         * \param params Generator parameters.
+         * \return True if the mesh changed.
+         */
+        bool replace(sol::IMesh*& mesh, TextGenerator& generator, const Generator::Params& params);
+
+        /**
+         * \brief Destroy all meshes that are not referenced.
+         */
+        void trim();
+
+    private:
+        struct Key
+        {
+            std::string text;
+
+            const FontMap* fontMap = nullptr;
+
+            const sol::MeshManager* meshManager = nullptr;
+        };
+
+        struct KeyView
+        {
+            std::string_view text;
+
+            const FontMap* fontMap = nullptr;
+
+            const sol::MeshManager* meshManager = nullptr;
+        };
+
+        struct KeyHash
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] size_t operator()(const KeyView& key) const noexcept;
+
+            [[nodiscard]] size_t operator()(const Key& key) const noexcept
+            {
+                return (*this)(KeyView{key.text, key.fontMap, key.meshManager});
+            }
+        };
+
+        struct KeyEqual
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] static KeyView view(const Key& key) noexcept
+            {
+                return {key.text, key.fontMap, key.meshManager};
+            }
+
+            [[nodiscard]] static KeyView view(const KeyView& key) noexcept { return key; }
+
+            [[nodiscard]] bool operator()(const auto& lhs, const auto& rhs) const noexcept
+            {
+                const auto l = view(lhs);
+                const auto r = view(rhs);
+                return l.text == r.text && l.fontMap == r.fontMap && l.meshManager == r.meshManager;
+            }
+        };
+
+        struct Entry
+        {
+            sol::IMesh* mesh = nullptr;
+
+            size_t references = 0;
+
+            size_t size = 0;
+
+            /**
+             * \brief Position in the list of unreferenced meshes. Only valid if references is 0.
+             */
+            std::list<const sol::IMesh*>::iterator unused;
+        };
+
+        /**
+         * \brief Evict unreferenced meshes until memory usage is below the cap.
+         */
+        void evict();
+
+        std::unordered_map<Key, Entry, KeyHash, KeyEqual> entries;
+
+        /**
+         * \brief Reverse lookup from mesh to the key of its entry, used when releasing.
+         */
+        std::unordered_map<const sol::IMesh*, const Key*> keys;
+
+        /**
+         * \brief Unreferenced meshes, least recently used first.
+         */
+        std::list<const sol::IMesh*> unused;
+
+        size_t memoryUsage = 0;
+
+        size_t memoryCap = default_memory_cap;
+    };
+}  // namespace floah
@@ -13,6 +13,9 @@
 #include "floah-data/i_bool_data_source.h"
 #include "floah-layout/layout_element.h"
 #include "floah-layout/elements/horizontal_flow.h"
+#include "floah-viz/generators/circle_generator.h"
+#include "floah-viz/generators/rectangle_generator.h"
+#include "floah-viz/generators/text_generator.h"
 #include "floah-viz/scenegraph/transform_node.h"
 
 ////////////////////////////////////////////////////////////////
@@ -77,6 +80,8 @@ namespace floah
 
         [[nodiscard]] virtual IBoolDataSource* getDataSource() const noexcept;
 
+        [[nodiscard]] StaleData getStyleDependency(StyleKey key) const noexcept override;
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
@@ -89,6 +94,8 @@ namespace floah
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        void prepareLayout() override;
+
         void generateLayout(Size size, Size offset) override;
 
         void generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap) override;
@@ -114,10 +121,31 @@ namespace floah
         void onDataSourceUpdate(DataSource& source) override;
 
     protected:
+        ////////////////////////////////////////////////////////////////
+        // Geometry.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the shape of the box, centered on the origin. Requires the layout to be generated.
+         * \return Shape.
+         */
+        [[nodiscard]] RectangleShape getBoxShape() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Scenegraph.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clear the meshes of the nodes and put them into the node pool of the panel.
+         */
+        void releaseNodes();
+
         ////////////////////////////////////////////////////////////////
         // Stylesheet getters.
         ////////////////////////////////////////////////////////////////
 
+        void resolveStyle() override;
+
         // [[nodiscard]] ? getFlow() const noexcept;
 
         [[nodiscard]] Length getBoxHeight() const noexcept;
@@ -148,6 +176,22 @@ namespace floah
 
         std::string label;
 
+        /**
+         * \brief Stylesheet properties resolved by resolveStyle.
+         */
+        struct
+        {
+            Length                        boxHeight;
+            Margin                        boxMargin;
+            Length                        boxWidth;
+            Length                        labelHeight;
+            Margin                        labelMargin;
+            Length                        labelWidth;
+            sol::ForwardMaterialInstance* textMaterial   = nullptr;
+            sol::ForwardMaterialInstance* widgetMaterial = nullptr;
+            math::float4                  color;
+        } style;
+
         struct
         {
             HorizontalFlow* root  = nullptr;
@@ -161,6 +205,10 @@ namespace floah
             Block* label = nullptr;
         } blocks;
 
+        /**
+         * \brief Generated meshes. The box, highlight and checkmark are shared through the mesh cache of the panel, the
+         * label through the text mesh cache.
+         */
         struct
         {
             sol::IMesh* box       = nullptr;
@@ -171,11 +219,29 @@ namespace floah
 
         struct
         {
-            sol::Node* root      = nullptr;
-            sol::Node* highlight = nullptr;
-            sol::Node* checkmark = nullptr;
+            sol::MeshNode*  box             = nullptr;
+            sol::MeshNode*  highlight       = nullptr;
+            sol::MeshNode*  checkmark       = nullptr;
+            sol::MeshNode*  label           = nullptr;
+            ITransformNode* widgetTransform = nullptr;
+            ITransformNode* labelTransform  = nullptr;
         } nodes;
 
+        /**
+         * \brief Instances of the box, highlight and checkmark, used instead of their nodes if instancing is enabled.
+         */
+        struct
+        {
+            InstanceHandle box;
+            InstanceHandle highlight;
+            InstanceHandle checkmark;
+        } instances;
+
+        /**
+         * \brief Sub-range of the box in the static batches, used instead of its mesh and node if batching is enabled.
+         */
+        StaticGeometryHandle batchedBox;
+
         IBoolDataSource* dataSource = nullptr;
 
         struct
@@ -4,7 +4,10 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////
@@ -16,17 +19,21 @@
 #include "floah-layout/layout_element.h"
 #include "floah-layout/elements/horizontal_flow.h"
 #include "floah-layout/elements/vertical_flow.h"
+#include "floah-viz/generators/rectangle_generator.h"
+#include "floah-viz/generators/text_generator.h"
 #include "floah-viz/scenegraph/transform_node.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-widget/list_change.h"
+#include "floah-widget/paged_list_loader.h"
 #include "floah-widget/widgets/widget.h"
 
 namespace floah
 {
-    class Dropdown : public Widget
+    class Dropdown : public Widget, public ListChangeListener
     {
     public:
         static constexpr char dropdown_flow[]            = "dropdown.flow";
@@ -43,6 +50,10 @@ namespace floah
         static constexpr char dropdown_label_width[]     = "dropdown.label.width";
         static constexpr char dropdown_material_text[]   = "dropdown.material.text";
         static constexpr char dropdown_material_widget[] = "dropdown.material.widget";
+        /**
+         * \brief Text shown for items that are still being fetched.
+         */
+        static constexpr char item_placeholder[] = "...";
         // dropdown_flow_default
 
         static constexpr Length dropdown_box_height_default = Length(1.0f);
@@ -88,26 +99,51 @@ namespace floah
 
         [[nodiscard]] virtual IIntegralValueDataSource* getIndexDataSource() const noexcept;
 
+        /**
+         * \brief Get the number of items fetched at once on a worker thread.
+         * \return Page size or 0 if items are fetched synchronously.
+         */
+        [[nodiscard]] size_t getItemsPageSize() const noexcept;
+
+        [[nodiscard]] StaleData getStyleDependency(StyleKey key) const noexcept override;
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
 
         virtual void setLabel(std::string l);
 
+        /**
+         * \brief Set the items data source. If the source is also a ListChangeNotifier, the changes it reports are
+         * applied incrementally, and the selected index is shifted along with the selected item.
+         * \param source Source or nullptr.
+         */
         virtual void setItemsDataSource(IListDataSource* source);
 
         virtual void setIndexDataSource(IIntegralValueDataSource* source);
 
+        /**
+         * \brief Fetch items asynchronously in pages of the given size. Rows show a placeholder until their page
+         * arrives. The items data source must then be thread-safe, and its getSize method is still called
+         * synchronously.
+         * \param size Page size or 0 to fetch items synchronously.
+         */
+        void setItemsPageSize(size_t size);
+
         ////////////////////////////////////////////////////////////////
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        void prepareLayout() override;
+
         void generateLayout(Size size, Size offset) override;
 
         void generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap) override;
 
         void generateScenegraph(IScenegraphGenerator& generator) override;
 
+        void poll() override;
+
         ////////////////////////////////////////////////////////////////
         // Input.
         ////////////////////////////////////////////////////////////////
@@ -131,11 +167,44 @@ namespace floah
 
         void onDataSourceUpdate(DataSource& source) override;
 
+        ////////////////////////////////////////////////////////////////
+        // ListChangeListener.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Apply a change of the items data source. Items that stay visible keep their mesh, and only the value
+         * and visible rows that are affected by the change are regenerated.
+         * \param source List data source.
+         * \param change Change.
+         */
+        void onListDataSourceUpdate(IListDataSource& source, const ListChange& change) override;
+
     protected:
+        ////////////////////////////////////////////////////////////////
+        // Geometry.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the shape of the box, centered on the origin. Requires the layout to be generated.
+         * \return Shape.
+         */
+        [[nodiscard]] RectangleShape getBoxShape() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Scenegraph.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clear the meshes of the nodes and put them into the node pool of the panel.
+         */
+        void releaseNodes();
+
         ////////////////////////////////////////////////////////////////
         // Stylesheet getters.
         ////////////////////////////////////////////////////////////////
 
+        void resolveStyle() override;
+
         // [[nodiscard]] ? getFlow() const noexcept;
 
 
@@ -175,12 +244,56 @@ namespace floah
          */
         void calculateScroll() noexcept;
 
+        /**
+         * \brief Get the number of item rows that are visible when the dropdown is opened.
+         * \return Number of rows.
+         */
+        [[nodiscard]] size_t getVisibleItemCount() const noexcept;
+
+        /**
+         * \brief Get the mesh of a visible item row.
+         * \param row Row.
+         * \return Mesh or nullptr if the row is empty or its mesh was not generated yet.
+         */
+        [[nodiscard]] sol::IMesh* getItemMesh(size_t row) const noexcept;
+
+        /**
+         * \brief Recreate the asynchronous item loader for the current data source and page size.
+         */
+        void resetItemsLoader();
+
+        /**
+         * \brief Get the string of an item, either directly from the data source or from the loader.
+         * \param index Item index.
+         * \param text Receives the string, or the placeholder if the item is still being fetched.
+         * \return True if the item is available, false if it is still being fetched.
+         */
+        bool fetchItem(size_t index, std::string& text) const;
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
         std::string label;
 
+        /**
+         * \brief Stylesheet properties resolved by resolveStyle.
+         */
+        struct
+        {
+            Length                        boxHeight;
+            Margin                        boxMargin;
+            Length                        boxWidth;
+            Length                        itemsHeight;
+            size_t                        itemsMax = dropdown_items_max_default;
+            Length                        labelHeight;
+            Margin                        labelMargin;
+            Length                        labelWidth;
+            sol::ForwardMaterialInstance* textMaterial   = nullptr;
+            sol::ForwardMaterialInstance* widgetMaterial = nullptr;
+            math::float4                  color;
+        } style;
+
         struct
         {
             VerticalFlow*   root   = nullptr;
@@ -198,31 +311,92 @@ namespace floah
             Block* items = nullptr;
         } blocks;
 
+        /**
+         * \brief Text mesh of an item. Items are stored in a ring of itemsMax slots, where item i goes into slot
+         * i % itemsMax. Scrolling by a number of rows therefore only invalidates as many slots.
+         */
+        struct ItemSlot
+        {
+            static constexpr size_t invalid_index = std::numeric_limits<size_t>::max();
+
+            /**
+             * \brief Index of the item in the data source.
+             */
+            size_t index = invalid_index;
+
+            sol::IMesh* mesh = nullptr;
+
+            /**
+             * \brief Whether the mesh shows the placeholder, because the item is still being fetched.
+             */
+            bool placeholder = false;
+        };
+
         struct
         {
-            sol::IMesh*              box       = nullptr;
-            sol::IMesh*              highlight = nullptr;
-            sol::IMesh*              value     = nullptr;
-            sol::IMesh*              label     = nullptr;
-            std::vector<sol::IMesh*> items;
-            sol::IMesh*              itemsBack      = nullptr;
-            sol::IMesh*              itemsHighlight = nullptr;
+            sol::IMesh*           box       = nullptr;
+            sol::IMesh*           highlight = nullptr;
+            sol::IMesh*           value     = nullptr;
+            sol::IMesh*           label     = nullptr;
+            std::vector<ItemSlot> items;
+            sol::IMesh*           itemsBack      = nullptr;
+            sol::IMesh*           itemsHighlight = nullptr;
         } meshes;
 
+        /**
+         * \brief Scenegraph nodes of a row in the list of items.
+         */
+        struct ItemNodes
+        {
+            ITransformNode* transform = nullptr;
+
+            sol::MeshNode* node = nullptr;
+
+            /**
+             * \brief Mesh last assigned to the node.
+             */
+            sol::IMesh* mesh = nullptr;
+
+            /**
+             * \brief Z coordinate last assigned to the transform.
+             */
+            float z = 0;
+        };
+
         struct
         {
-            sol::Node*      root                    = nullptr;
-            sol::Node*      highlight               = nullptr;
-            sol::Node*      widgetItems             = nullptr;
-            ITransformNode* itemsHighlightTransform = nullptr;
-            sol::Node*      textItems               = nullptr;
-            sol::MeshNode*  value                   = nullptr;
+            sol::MeshNode*         box                     = nullptr;
+            sol::MeshNode*         highlight               = nullptr;
+            sol::Node*             widgetItems             = nullptr;
+            ITransformNode*        widgetTransform         = nullptr;
+            ITransformNode*        valueTransform          = nullptr;
+            ITransformNode*        labelTransform          = nullptr;
+            ITransformNode*        itemsBackTransform      = nullptr;
+            ITransformNode*        itemsHighlightTransform = nullptr;
+            sol::MeshNode*         itemsBack               = nullptr;
+            sol::MeshNode*         itemsHighlight          = nullptr;
+            sol::Node*             textItems               = nullptr;
+            sol::MeshNode*         value                   = nullptr;
+            sol::MeshNode*         label                   = nullptr;
+            std::vector<ItemNodes> items;
         } nodes;
 
+        /**
+         * \brief Sub-range of the box in the static batches, used instead of its mesh and node if batching is enabled.
+         */
+        StaticGeometryHandle batchedBox;
+
         IListDataSource* itemsDataSource = nullptr;
 
         IIntegralValueDataSource* indexDataSource = nullptr;
 
+        size_t itemsPageSize = 0;
+
+        /**
+         * \brief Fetches items asynchronously. Only set if itemsPageSize is not 0.
+         */
+        std::unique_ptr<PagedListLoader> itemsLoader;
+
         struct
         {
             bool entered = false;
@@ -238,6 +412,14 @@ namespace floah
 
             bool isValueMeshState = false;
 
+            /**
+             * \brief Whether the value mesh shows the placeholder, because the item is still being fetched.
+             */
+            bool isValuePlaceholder = false;
+
+            /**
+             * \brief Whether all item slots need to be regenerated, e.g. because the data source changed.
+             */
             bool isItemsMeshStale = false;
         } state;
     };
@@ -14,6 +14,10 @@
 #include "floah-data/i_bool_data_source.h"
 #include "floah-layout/layout_element.h"
 #include "floah-layout/elements/horizontal_flow.h"
+#include "floah-viz/generators/circle_generator.h"
+#include "floah-viz/generators/rectangle_generator.h"
+#include "floah-viz/generators/text_generator.h"
+#include "floah-viz/scenegraph/transform_node.h"
 
 ////////////////////////////////////////////////////////////////
 // Current target includes.
@@ -92,6 +96,8 @@ namespace floah
          */
         [[nodiscard]] RadioButton* getMainButton() const noexcept;
 
+        [[nodiscard]] StaleData getStyleDependency(StyleKey key) const noexcept override;
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
@@ -104,6 +110,8 @@ namespace floah
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        void prepareLayout() override;
+
         void generateLayout(Size size, Size offset) override;
 
         void generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap) override;
@@ -135,10 +143,31 @@ namespace floah
 
         void setMain(RadioButton& setButton);
 
+        ////////////////////////////////////////////////////////////////
+        // Geometry.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the shape of the box, centered on the origin. Requires the layout to be generated.
+         * \return Shape.
+         */
+        [[nodiscard]] RectangleShape getBoxShape() const;
+
+        ////////////////////////////////////////////////////////////////
+        // Scenegraph.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Clear the meshes of the nodes and put them into the node pool of the panel.
+         */
+        void releaseNodes();
+
         ////////////////////////////////////////////////////////////////
         // Stylesheet getters.
         ////////////////////////////////////////////////////////////////
 
+        void resolveStyle() override;
+
         // [[nodiscard]] ? getFlow() const noexcept;
 
         [[nodiscard]] Length getBoxHeight() const noexcept;
@@ -169,6 +198,22 @@ namespace floah
 
         std::string label;
 
+        /**
+         * \brief Stylesheet properties resolved by resolveStyle.
+         */
+        struct
+        {
+            Length                        boxHeight;
+            Margin                        boxMargin;
+            Length                        boxWidth;
+            Length                        labelHeight;
+            Margin                        labelMargin;
+            Length                        labelWidth;
+            sol::ForwardMaterialInstance* textMaterial   = nullptr;
+            sol::ForwardMaterialInstance* widgetMaterial = nullptr;
+            math::float4                  color;
+        } style;
+
         struct
         {
             HorizontalFlow* root  = nullptr;
@@ -182,6 +227,10 @@ namespace floah
             Block* label = nullptr;
         } blocks;
 
+        /**
+         * \brief Generated meshes. The box, highlight and checkmark are shared through the mesh cache of the panel, the
+         * label through the text mesh cache.
+         */
         struct
         {
             sol::IMesh* box       = nullptr;
@@ -192,11 +241,29 @@ namespace floah
 
         struct
         {
-            sol::Node* root      = nullptr;
-            sol::Node* highlight = nullptr;
-            sol::Node* checkmark = nullptr;
+            sol::MeshNode*  box             = nullptr;
+            sol::MeshNode*  highlight       = nullptr;
+            sol::MeshNode*  checkmark       = nullptr;
+            sol::MeshNode*  label           = nullptr;
+            ITransformNode* widgetTransform = nullptr;
+            ITransformNode* labelTransform  = nullptr;
         } nodes;
 
+        /**
+         * \brief Instances of the box, highlight and checkmark, used instead of their nodes if instancing is enabled.
+         */
+        struct
+        {
+            InstanceHandle box;
+            InstanceHandle highlight;
+            InstanceHandle checkmark;
+        } instances;
+
+        /**
+         * \brief Sub-range of the box in the static batches, used instead of its mesh and node if batching is enabled.
+         */
+        StaticGeometryHandle batchedBox;
+
         IBoolDataSource* dataSource = nullptr;
 
         /**
@@ -4,7 +4,10 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <any>
 #include <memory>
+#include <optional>
+#include <typeindex>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////
@@ -18,6 +21,20 @@
 #include "floah-viz/stylesheet.h"
 #include "floah-viz/scenegraph/scenegraph_generator.h"
 #include "sol/mesh/fwd.h"
+#include "sol/scenegraph/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/instance_batches.h"
+#include "floah-widget/mesh_cache.h"
+#include "floah-widget/node_pool.h"
+#include "floah-widget/slot_map.h"
+#include "floah-widget/static_batches.h"
+#include "floah-widget/style_cache.h"
+#include "floah-widget/style_key.h"
+#include "floah-widget/text_mesh_cache.h"
 
 namespace floah
 {
@@ -25,8 +42,9 @@ namespace floah
     class Panel;
     class Widget;
 
-    using PanelPtr  = std::unique_ptr<Panel>;
-    using WidgetPtr = std::unique_ptr<Widget>;
+    using PanelPtr     = std::unique_ptr<Panel>;
+    using WidgetPtr    = std::unique_ptr<Widget>;
+    using WidgetHandle = SlotMapHandle;
 
     class Widget : public InputElement, public DataListener
     {
@@ -42,10 +60,16 @@ namespace floah
 
         enum class StaleData
         {
+            None       = 0,
             Layout     = 1,
             Geometry   = 2,
             Scenegraph = 4,
-            All        = Layout | Geometry | Scenegraph
+            /**
+             * \brief Layout was moved without changing size. Only the offsets of transform nodes need to be updated
+             * during scenegraph generation.
+             */
+            Transform = 8,
+            All       = Layout | Geometry | Scenegraph | Transform
         };
 
         ////////////////////////////////////////////////////////////////
@@ -85,6 +109,12 @@ namespace floah
          */
         [[nodiscard]] const Panel& getPanel() const noexcept;
 
+        /**
+         * \brief Get the handle of this widget in its panel.
+         * \return Handle.
+         */
+        [[nodiscard]] WidgetHandle getHandle() const noexcept;
+
         /**
          * \brief Get the optional layer this widget is in.
          * \return Layer.
@@ -139,6 +169,15 @@ namespace floah
          */
         [[nodiscard]] const Stylesheet* getPanelStylesheet() const noexcept;
 
+        /**
+         * \brief Get the data that depends on a stylesheet property and needs to be regenerated when it changes. The
+         * default implementation only knows the shared material properties and conservatively returns All for any
+         * other key. Widgets should override this for the properties they read and return None for the rest.
+         * \param key Property key.
+         * \return StaleData.
+         */
+        [[nodiscard]] virtual StaleData getStyleDependency(StyleKey key) const noexcept;
+
         /**
          * \brief Get the data that is stale and needs to be regenerated.
          * \return StaleData.
@@ -156,10 +195,17 @@ namespace floah
         void setPanelLayoutElement(LayoutElement& element);
 
         /**
-         * \brief Set the widget stylesheet.
+         * \brief Set the widget stylesheet. If the stylesheet is different, the resolved style is invalidated.
          * \param sheet Stylesheet or nullptr.
          */
-        void setStylesheet(Stylesheet* sheet) noexcept;
+        void setStylesheet(Stylesheet* sheet);
+
+        /**
+         * \brief Invalidate the resolved style, marking all data as stale. Must be called after modifying the widget
+         * or panel stylesheet in place, unless the modified properties are reported through
+         * Panel::notifyStylesheetChanged instead.
+         */
+        void invalidateStyle();
 
         /**
          * \brief Replace current data source with new data soruce. Automatically takes care of removing and adding data listener.
@@ -182,12 +228,37 @@ namespace floah
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Prepare the widget layout for generation, e.g. by creating its elements. Always called serially
+         * before generateLayout.
+         */
+        virtual void prepareLayout();
+
+        /**
+         * \brief Generate the widget layout. May run concurrently with the layout generation of other widgets, so
+         * implementations must not modify anything outside of this widget, and any data source they read must be
+         * thread-safe.
+         * \param size Size of the block in the panel layout.
+         * \param offset Offset of the block in the panel layout.
+         */
         virtual void generateLayout(Size size, Size offset);
 
+        /**
+         * \brief Move the generated layout without regenerating it. Marks the transforms as stale.
+         * \param delta Offset to move by.
+         */
+        virtual void translateLayout(math::int2 delta);
+
         virtual void generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap) = 0;
 
         virtual void generateScenegraph(IScenegraphGenerator& generator) = 0;
 
+        /**
+         * \brief Process asynchronous work that completed since the last call, e.g. by marking data as stale. Called
+         * by Panel::update before any generate stage, for widgets that enabled polling.
+         */
+        virtual void poll();
+
         ////////////////////////////////////////////////////////////////
         // Input.
         ////////////////////////////////////////////////////////////////
@@ -199,12 +270,192 @@ namespace floah
         [[nodiscard]] math::int2 getInputOffset() const noexcept override;
 
     protected:
+        ////////////////////////////////////////////////////////////////
+        // Stale data.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Mark data as stale. Adds this widget to the work queues of its panel for the stale stages.
+         * \param data Stale data.
+         */
+        void markStale(StaleData data);
+
+        /**
+         * \brief Invalidate the resolved style without dropping cached stylesheet properties, marking all data as
+         * stale.
+         */
+        void markStyleStale();
+
+        /**
+         * \brief Enable or disable calls to poll by the panel.
+         * \param enabled Enabled.
+         */
+        void setPolling(bool enabled);
+
+        ////////////////////////////////////////////////////////////////
+        // Geometry.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the mesh cache of the panel.
+         * \return MeshCache or nullptr if this widget is not in a panel.
+         */
+        [[nodiscard]] MeshCache* getMeshCache() const noexcept;
+
+        /**
+         * \brief Get the text mesh cache of the panel.
+         * \return TextMeshCache or nullptr if this widget is not in a panel.
+         */
+        [[nodiscard]] TextMeshCache* getTextMeshCache() const noexcept;
+
+        /**
+         * \brief Get the instance batches of the panel, if instancing is enabled.
+         * \return InstanceBatches or nullptr if this widget is not in a panel or instancing is disabled.
+         */
+        [[nodiscard]] InstanceBatches* getInstanceBatches() const noexcept;
+
+        /**
+         * \brief Get the static batches of the panel, if batching is enabled.
+         * \return StaticBatches or nullptr if this widget is not in a panel or batching is disabled.
+         */
+        [[nodiscard]] StaticBatches* getStaticBatches() const noexcept;
+
+        /**
+         * \brief Release a mesh acquired from the mesh cache of the panel. The mesh is released by the next panel
+         * update, after the nodes of destroyed widgets were detached.
+         * \param mesh Mesh or nullptr. Reset to nullptr.
+         */
+        void releaseMesh(sol::IMesh*& mesh);
+
+        /**
+         * \brief Release a mesh acquired from the text mesh cache of the panel. The mesh is released by the next panel
+         * update, after the nodes of destroyed widgets were detached.
+         * \param mesh Mesh or nullptr. Reset to nullptr.
+         */
+        void releaseTextMesh(sol::IMesh*& mesh);
+
+        ////////////////////////////////////////////////////////////////
+        // Scenegraph.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Take ownership of a node created by this widget whose parent is not owned by this widget, such as a
+         * transform node under a material node of the panel. Owned nodes are detached by the first panel update after
+         * this widget is destroyed.
+         * \param node Node.
+         */
+        void ownNode(sol::Node& node);
+
+        /**
+         * \brief Adopt the nodes of a destroyed widget of the same type, or prepare for creating new nodes. Must be
+         * called before creating nodes. On success, the owned nodes of the destroyed widget are owned by this widget.
+         * \param type Type of the widget that created the nodes.
+         * \param widgetMaterial Material of the widget material node the nodes are attached to.
+         * \param textMaterial Material of the text material node the nodes are attached to.
+         * \return Nodes passed to poolNodes by the destroyed widget, or empty.
+         */
+        [[nodiscard]] std::any adoptNodes(std::type_index                     type,
+                                          const sol::ForwardMaterialInstance* widgetMaterial,
+                                          const sol::ForwardMaterialInstance* textMaterial);
+
+        /**
+         * \brief Put the owned nodes of this widget into the node pool of the panel instead of destroying them. Should
+         * be called when destroying the widget, after all mesh nodes were cleared.
+         * \param nodes Widget specific structure with pointers to the nodes, returned by adoptNodes later on.
+         */
+        void poolNodes(std::any nodes);
+
+        /**
+         * \brief Check whether the owned nodes are attached to the material nodes of other materials than the given
+         * ones, e.g. because the style changed after they were created. Such nodes should be pooled and replaced by
+         * nodes that are adopted or created below the material nodes of the given materials.
+         * \param widgetMaterial Material of the widget material node.
+         * \param textMaterial Material of the text material node.
+         * \return True if the materials differ from the ones passed to adoptNodes.
+         */
+        [[nodiscard]] bool nodeMaterialsChanged(const sol::ForwardMaterialInstance* widgetMaterial,
+                                                const sol::ForwardMaterialInstance* textMaterial) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Layout blocks.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Bind a block pointer to the block generated for an element of the widget layout. The pointer is
+         * updated by generateLayout and remains valid until the next layout generation, or longer if the number of
+         * blocks does not change.
+         * \param element Element in the widget layout.
+         * \param block Block pointer to update.
+         */
+        void bindLayoutBlock(const LayoutElement& element, Block*& block);
+
+        ////////////////////////////////////////////////////////////////
+        // Style.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Resolve all stylesheet properties used by this widget and cache them.
+         */
+        virtual void resolveStyle();
+
+        /**
+         * \brief Resolve the style if it was invalidated since it was last resolved.
+         */
+        void updateStyle();
+
+        /**
+         * \brief Get the style cache of the panel.
+         * \return StyleCache or nullptr if this widget is not in a panel.
+         */
+        [[nodiscard]] StyleCache* getStyleCache() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Stylesheet getter.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Get a property from the widget stylesheet, falling back to the panel stylesheet. Lookups are cached by
+         * key hash in the panel.
+         * \tparam T Property type.
+         * \param key Property key.
+         * \return Property value or empty.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> getStylesheetProperty(const StyleKey key) const
+        {
+            auto*      cache  = getStyleCache();
+            const auto lookup = [&](const Stylesheet& sheet) {
+                return cache ? cache->get<T>(sheet, key) : sheet.get<T>(std::string(key.getName()));
+            };
+
+            // Try to retrieve property from widget stylesheet.
+            if (stylesheet)
+            {
+                const auto opt = lookup(*stylesheet);
+                if (opt) return *opt;
+            }
+
+            // Try to retrieve property from panel stylesheet.
+            if (getPanelStylesheet())
+            {
+                const auto opt = lookup(*getPanelStylesheet());
+                if (opt) return *opt;
+            }
+
+            return {};
+        }
+
+        /**
+         * \brief Get a property from the widget stylesheet, falling back to the panel stylesheet. Constant character
+         * arrays are converted to a StyleKey instead.
+         * \tparam T Property type.
+         * \tparam N Name type.
+         * \param name Property name.
+         * \return Property value or empty.
+         */
         template<typename T, typename N>
-        [[nodiscard]] std::optional<T> getStylesheetProperty(N name) const
+            requires(!std::is_array_v<std::remove_cvref_t<N>> && !std::same_as<std::remove_cvref_t<N>, StyleKey>)
+        [[nodiscard]] std::optional<T> getStylesheetProperty(N&& name) const
         {
             // Try to retrieve property from widget stylesheet.
             if (stylesheet)
@@ -232,6 +483,11 @@ namespace floah
          */
         Panel* panel = nullptr;
 
+        /**
+         * \brief Handle of this widget in its panel.
+         */
+        WidgetHandle handle;
+
         /**
          * \brief Optional layer this widget is in.
          */
@@ -254,11 +510,53 @@ namespace floah
          */
         std::vector<Block> layoutBlocks;
 
+        /**
+         * \brief Block pointers bound to elements of the widget layout.
+         */
+        struct LayoutBlockBinding
+        {
+            const LayoutElement* element = nullptr;
+
+            Block** block = nullptr;
+
+            /**
+             * \brief Index into layoutBlocks at which the block was last found.
+             */
+            size_t index = 0;
+        };
+
+        std::vector<LayoutBlockBinding> layoutBlockBindings;
+
+        /**
+         * \brief Nodes registered through ownNode.
+         */
+        std::vector<sol::Node*> ownedNodes;
+
+        /**
+         * \brief Pool key of the owned nodes, set by adoptNodes.
+         */
+        std::optional<NodePool::Key> nodePoolKey;
+
         /**
          * \brief Widget stylesheet.
          */
         Stylesheet* stylesheet = nullptr;
 
         StaleData staleData = StaleData::All;
+
+        /**
+         * \brief Whether the stylesheets changed since the style was last resolved.
+         */
+        bool styleStale = true;
+
+        /**
+         * \brief Stages for which this widget is currently in one of the panel work queues.
+         */
+        StaleData queuedData = StaleData::None;
+
+        /**
+         * \brief Whether this widget is polled by the panel.
+         */
+        bool polling = false;
     };
 }  // namespace floah
@@ -0,0 +1,81 @@
+#include "floah-widget/destruction_queue.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/flat_mesh.h"
+#include "sol/mesh/mesh_manager.h"
+#include "sol/scenegraph/drawable/mesh_node.h"
+#include "sol/scenegraph/node.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/node_masks.h"
+
+namespace
+{
+    void clearMeshes(sol::Node& node)
+    {
+        if (auto* meshNode = dynamic_cast<sol::MeshNode*>(&node)) meshNode->setMesh(nullptr);
+        for (auto& child : node.getChildren()) clearMeshes(*child);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    DestructionQueue::~DestructionQueue() noexcept { flush(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    bool DestructionQueue::empty() const noexcept
+    {
+        return nodes.empty() && meshes.empty() && textMeshes.empty() && ownedMeshes.empty();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Queue.
+    ////////////////////////////////////////////////////////////////
+
+    void DestructionQueue::enqueue(sol::Node& node) { nodes.push_back(&node); }
+
+    void DestructionQueue::enqueue(MeshCache& cache, const sol::IMesh* mesh)
+    {
+        if (mesh) meshes.emplace_back(&cache, mesh);
+    }
+
+    void DestructionQueue::enqueue(TextMeshCache& cache, const sol::IMesh* mesh)
+    {
+        if (mesh) textMeshes.emplace_back(&cache, mesh);
+    }
+
+    void DestructionQueue::enqueue(sol::IMesh& mesh) { ownedMeshes.push_back(&mesh); }
+
+    void DestructionQueue::flush()
+    {
+        // The scenegraph cannot detach nodes. They are disabled instead, and stop referring to any meshes, so that
+        // the meshes can be released below. The nodes stay in the scenegraph until its owner destroys it.
+        for (auto* node : nodes)
+        {
+            node->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+            clearMeshes(*node);
+        }
+
+        for (const auto& [cache, mesh] : meshes) cache->release(mesh);
+        for (const auto& [cache, mesh] : textMeshes) cache->release(mesh);
+        for (auto* mesh : ownedMeshes) mesh->getMeshManager().destroyMesh(mesh->getUuid());
+
+        nodes.clear();
+        meshes.clear();
+        textMeshes.clear();
+        ownedMeshes.clear();
+    }
+}  // namespace floah
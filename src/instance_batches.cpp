@@ -0,0 +1,167 @@
+#include "floah-widget/instance_batches.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    InstanceBatch::InstanceBatch(const std::type_index         widgetType,
+                                 sol::IMesh&                   batchMesh,
+                                 sol::ForwardMaterialInstance* batchMaterial) :
+        type(widgetType), mesh(&batchMesh), material(batchMaterial)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::type_index InstanceBatch::getType() const noexcept { return type; }
+
+    sol::IMesh& InstanceBatch::getMesh() const noexcept { return *mesh; }
+
+    sol::ForwardMaterialInstance* InstanceBatch::getMaterial() const noexcept { return material; }
+
+    std::span<const InstanceData> InstanceBatch::getInstances() const noexcept
+    {
+        return {instances.begin(), instances.end()};
+    }
+
+    size_t InstanceBatch::size() const noexcept { return instances.size(); }
+
+    std::pair<size_t, size_t> InstanceBatch::getDirtyRange() const noexcept { return dirty; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void InstanceBatch::clearDirtyRange() noexcept { dirty = {0, 0}; }
+
+    void InstanceBatch::markDirty(const size_t index) noexcept
+    {
+        if (dirty.first == dirty.second)
+            dirty = {index, index + 1};
+        else
+            dirty = {std::min(dirty.first, index), std::max(dirty.second, index + 1)};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::vector<std::unique_ptr<InstanceBatch>>& InstanceBatches::getBatches() const noexcept
+    {
+        return batches;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Instances.
+    ////////////////////////////////////////////////////////////////
+
+    InstanceHandle InstanceBatches::create(const std::type_index         type,
+                                           sol::IMesh&                   mesh,
+                                           sol::ForwardMaterialInstance* material,
+                                           const InstanceData            data)
+    {
+        const Key key{.type = type, .mesh = &mesh, .material = material};
+        auto      it = batchIndex.find(key);
+        if (it == batchIndex.end())
+        {
+            it = batchIndex.try_emplace(key, batches.size()).first;
+            batches.emplace_back(std::make_unique<InstanceBatch>(type, mesh, material));
+        }
+
+        auto& batch = *batches[it->second];
+        batch.markDirty(batch.instances.size());
+        return {.batch = &batch, .handle = batch.instances.insert(data)};
+    }
+
+    void InstanceBatches::update(const InstanceHandle& handle, const InstanceData data)
+    {
+        if (!handle.valid()) return;
+
+        auto& batch    = *handle.batch;
+        auto* instance = batch.instances.find(handle.handle);
+        if (!instance) return;
+
+        *instance = data;
+        batch.markDirty(static_cast<size_t>(instance - &*batch.instances.begin()));
+    }
+
+    void InstanceBatches::replace(InstanceHandle&               handle,
+                                  const std::type_index         type,
+                                  sol::IMesh&                   mesh,
+                                  sol::ForwardMaterialInstance* material,
+                                  const InstanceData            data)
+    {
+        if (handle.valid() && handle.batch->type == type && handle.batch->mesh == &mesh &&
+            handle.batch->material == material)
+        {
+            update(handle, data);
+            return;
+        }
+
+        auto newHandle = create(type, mesh, material, data);
+        destroy(handle);
+        handle = newHandle;
+    }
+
+    void InstanceBatches::destroy(InstanceHandle& handle)
+    {
+        if (!handle.valid()) return;
+
+        auto&      batch    = *handle.batch;
+        const auto slot     = std::exchange(handle, {}).handle;
+        const auto instance = batch.instances.find(slot);
+        if (!instance) return;
+
+        // The last instance is moved into the position of the destroyed instance.
+        batch.markDirty(static_cast<size_t>(instance - &*batch.instances.begin()));
+        batch.instances.erase(slot);
+    }
+
+    std::vector<std::unique_ptr<InstanceBatch>> InstanceBatches::takeEmpty()
+    {
+        std::vector<std::unique_ptr<InstanceBatch>> empty;
+        for (size_t index = 0; index < batches.size();)
+        {
+            if (batches[index]->size() > 0)
+            {
+                index++;
+                continue;
+            }
+
+            // Take empty batch by moving the last batch into its position.
+            auto& batch = *batches[index];
+            batchIndex.erase(Key{.type = batch.type, .mesh = batch.mesh, .material = batch.material});
+            empty.emplace_back(std::move(batches[index]));
+            if (index != batches.size() - 1)
+            {
+                auto& last = *batches.back();
+                batchIndex.insert_or_assign(Key{.type = last.type, .mesh = last.mesh, .material = last.material},
+                                            index);
+                batches[index] = std::move(batches.back());
+            }
+            batches.pop_back();
+        }
+
+        return empty;
+    }
+
+    size_t InstanceBatches::KeyHash::operator()(const Key& key) const noexcept
+    {
+        auto h = key.type.hash_code();
+        h ^= std::hash<const void*>{}(key.mesh) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        h ^= std::hash<const void*>{}(key.material) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        return h;
+    }
+}  // namespace floah
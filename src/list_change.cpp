@@ -0,0 +1,30 @@
+#include "floah-widget/list_change.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Listeners.
+    ////////////////////////////////////////////////////////////////
+
+    void ListChangeNotifier::addListChangeListener(ListChangeListener& listener)
+    {
+        if (std::ranges::find(listeners, &listener) == listeners.end()) listeners.push_back(&listener);
+    }
+
+    void ListChangeNotifier::removeListChangeListener(ListChangeListener& listener)
+    {
+        std::erase(listeners, &listener);
+    }
+
+    void ListChangeNotifier::notifyListChange(IListDataSource& source, const ListChange& change)
+    {
+        // Listeners may unsubscribe while being notified.
+        for (auto* listener : std::vector(listeners)) listener->onListDataSourceUpdate(source, change);
+    }
+}  // namespace floah
@@ -0,0 +1,128 @@
+#include "floah-widget/mesh_cache.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <bit>
+#include <cmath>
+#include <ranges>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/flat_mesh.h"
+#include "sol/mesh/mesh_manager.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    MeshCache::~MeshCache() noexcept
+    {
+        for (const auto& entry : entries | std::views::values)
+            entry.mesh->getMeshManager().destroyMesh(entry.mesh->getUuid());
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t MeshCache::size() const noexcept { return entries.size(); }
+
+    ////////////////////////////////////////////////////////////////
+    // Meshes.
+    ////////////////////////////////////////////////////////////////
+
+    sol::IMesh& MeshCache::acquire(const RectangleShape& shape, const Generator::Params& params)
+    {
+        const Key key{.shape       = Shape::Rectangle,
+                      .meshManager = &params.meshManager,
+                      .values      = {toKeyValue(shape.lower[0]),
+                                      toKeyValue(shape.lower[1]),
+                                      toKeyValue(shape.upper[0]),
+                                      toKeyValue(shape.upper[1]),
+                                      static_cast<uint32_t>(shape.fillMode),
+                                      toKeyValue(shape.margin.get()),
+                                      toKeyValue(shape.color[0]),
+                                      toKeyValue(shape.color[1]),
+                                      toKeyValue(shape.color[2]),
+                                      toKeyValue(shape.color[3])}};
+
+        RectangleGenerator generator;
+        generator.lower    = shape.lower;
+        generator.upper    = shape.upper;
+        generator.fillMode = shape.fillMode;
+        generator.margin   = shape.margin;
+        generator.color    = shape.color;
+        return acquire(key, generator, params);
+    }
+
+    sol::IMesh& MeshCache::acquire(const CircleShape& shape, const Generator::Params& params)
+    {
+        const Key key{.shape       = Shape::Circle,
+                      .meshManager = &params.meshManager,
+                      .values      = {static_cast<uint32_t>(shape.fillMode), toKeyValue(shape.radius)}};
+
+        CircleGenerator generator;
+        generator.fillMode = shape.fillMode;
+        generator.radius   = shape.radius;
+        return acquire(key, generator, params);
+    }
+
+    void MeshCache::release(const sol::IMesh* mesh)
+    {
+        if (!mesh) return;
+
+        const auto keyIt = keys.find(mesh);
+        if (keyIt == keys.end()) return;
+
+        const auto it = entries.find(keyIt->second);
+        if (--it->second.references > 0) return;
+
+        it->second.mesh->getMeshManager().destroyMesh(it->second.mesh->getUuid());
+        entries.erase(it);
+        keys.erase(keyIt);
+    }
+
+    template<typename G>
+    sol::IMesh& MeshCache::acquire(const Key& key, G& generator, const Generator::Params& params)
+    {
+        auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            auto& mesh = generator.generate(params);
+            it         = entries.try_emplace(key, Entry{.mesh = &mesh}).first;
+            keys.try_emplace(&mesh, key);
+        }
+
+        it->second.references++;
+        return *it->second.mesh;
+    }
+
+    size_t MeshCache::KeyHash::operator()(const Key& key) const noexcept
+    {
+        // FNV-1a over the shape, mesh manager and all values.
+        uint64_t   h   = 14695981039346656037ull;
+        const auto mix = [&h](const uint64_t v) {
+            h ^= v;
+            h *= 1099511628211ull;
+        };
+
+        mix(static_cast<uint64_t>(key.shape));
+        mix(reinterpret_cast<uintptr_t>(key.meshManager));
+        for (const auto v : key.values) mix(v);
+
+        return static_cast<size_t>(h);
+    }
+
+    uint32_t MeshCache::toKeyValue(const float value) noexcept
+    {
+        if (value == 0.0f) return 0;
+        if (std::isnan(value)) return 0x7FC00000;
+        return std::bit_cast<uint32_t>(value);
+    }
+}  // namespace floah
@@ -0,0 +1,112 @@
+#include "floah-widget/node_pool.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <ranges>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/scenegraph/node.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-widget/node_masks.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    NodePool::NodePool(DestructionQueue& queue) : destructionQueue(&queue) {}
+
+    NodePool::~NodePool() noexcept
+    {
+        if (destructionQueue) clear();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t NodePool::getCapacity() const noexcept { return capacity; }
+
+    size_t NodePool::size() const noexcept
+    {
+        size_t count = 0;
+        for (const auto& list : entries | std::views::values) count += list.size();
+        return count;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void NodePool::setCapacity(const size_t cap)
+    {
+        capacity = cap;
+
+        for (auto& list : entries | std::views::values)
+        {
+            while (list.size() > capacity)
+            {
+                for (auto* root : list.back().roots) destructionQueue->enqueue(*root);
+                list.pop_back();
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Pool.
+    ////////////////////////////////////////////////////////////////
+
+    void NodePool::release(const Key& key, Entry entry)
+    {
+        auto& list = entries[key];
+        if (list.size() >= capacity)
+        {
+            for (auto* root : entry.roots) destructionQueue->enqueue(*root);
+            return;
+        }
+
+        for (auto* root : entry.roots) root->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+        list.emplace_back(std::move(entry));
+    }
+
+    bool NodePool::acquire(const Key& key, Entry& entry)
+    {
+        const auto it = entries.find(key);
+        if (it == entries.end() || it->second.empty()) return false;
+
+        entry = std::move(it->second.back());
+        it->second.pop_back();
+        for (auto* root : entry.roots) root->setTypeMask(0);
+
+        return true;
+    }
+
+    void NodePool::clear()
+    {
+        for (auto& list : entries | std::views::values)
+            for (const auto& entry : list)
+                for (auto* root : entry.roots) destructionQueue->enqueue(*root);
+
+        entries.clear();
+    }
+
+    size_t NodePool::KeyHash::operator()(const Key& key) const noexcept
+    {
+        auto h = key.type.hash_code();
+        h ^= std::hash<const void*>{}(key.widgetMaterial) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        h ^= std::hash<const void*>{}(key.textMaterial) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        return h;
+    }
+}  // namespace floah
@@ -0,0 +1,176 @@
+#include "floah-widget/paged_list_loader.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+#include <ranges>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    PagedListLoader::PagedListLoader(const IListDataSource& dataSource, const size_t size) :
+        source(&dataSource), pageSize(size)
+    {
+        if (pageSize == 0) throw FloahError("Cannot create PagedListLoader. Page size must be larger than 0.");
+        worker = std::jthread([this](const std::stop_token stop) { run(stop); });
+    }
+
+    PagedListLoader::~PagedListLoader() noexcept
+    {
+        worker.request_stop();
+        condition.notify_all();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const IListDataSource& PagedListLoader::getDataSource() const noexcept { return *source; }
+
+    size_t PagedListLoader::getPageSize() const noexcept { return pageSize; }
+
+    size_t PagedListLoader::getPageCapacity() const noexcept { return pageCapacity; }
+
+    const std::string* PagedListLoader::find(const size_t index) const
+    {
+        const auto it = pages.find(index / pageSize);
+        if (it == pages.end()) return nullptr;
+
+        const auto offset = index % pageSize;
+        return offset < it->second.size() ? &it->second[offset] : nullptr;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void PagedListLoader::setPageCapacity(const size_t cap)
+    {
+        if (cap == 0) throw FloahError("Cannot set page capacity. Capacity must be larger than 0.");
+        pageCapacity = cap;
+        evict();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Loading.
+    ////////////////////////////////////////////////////////////////
+
+    void PagedListLoader::request(const size_t first, const size_t count)
+    {
+        if (count == 0) return;
+
+        const auto& [firstPage, lastPage] = requests.emplace_back(first / pageSize, (first + count - 1) / pageSize);
+
+        std::vector<size_t> newPages;
+        for (size_t page = firstPage; page <= lastPage; page++)
+            if (!pages.contains(page) && requested.insert(page).second) newPages.push_back(page);
+        if (newPages.empty()) return;
+
+        {
+            std::scoped_lock lock(mutex);
+            // Worker takes pages from the back. Put the first page of the range there.
+            queue.insert(queue.end(), newPages.rbegin(), newPages.rend());
+        }
+        condition.notify_one();
+    }
+
+    bool PagedListLoader::poll()
+    {
+        std::vector<std::pair<size_t, std::vector<std::string>>> ps;
+        {
+            std::scoped_lock lock(mutex);
+            ps.swap(arrived);
+        }
+
+        for (auto& [page, strings] : ps)
+        {
+            requested.erase(page);
+            pages.insert_or_assign(page, std::move(strings));
+        }
+
+        // Without new requests, the previous ranges are still the best guess of what is needed.
+        if (!requests.empty())
+        {
+            recent.swap(requests);
+            requests.clear();
+        }
+        evict();
+
+        return !ps.empty();
+    }
+
+    void PagedListLoader::invalidate()
+    {
+        {
+            std::scoped_lock lock(mutex);
+            generation++;
+            queue.clear();
+            arrived.clear();
+        }
+
+        pages.clear();
+        requested.clear();
+    }
+
+    void PagedListLoader::evict()
+    {
+        if (pages.size() <= pageCapacity) return;
+
+        const auto distance = [this](const size_t page) {
+            auto d = std::numeric_limits<size_t>::max();
+            for (const auto& [first, last] : recent)
+                d = std::min(d, page < first ? first - page : page > last ? page - last : 0);
+            return d;
+        };
+
+        // Partition the pages so that the ones closest to the recent ranges come first, and drop the rest.
+        std::vector<size_t> ps;
+        ps.reserve(pages.size());
+        for (const auto page : pages | std::views::keys) ps.push_back(page);
+        std::ranges::nth_element(ps, ps.begin() + static_cast<ptrdiff_t>(pageCapacity), {}, distance);
+        for (auto it = ps.begin() + static_cast<ptrdiff_t>(pageCapacity); it != ps.end(); ++it) pages.erase(*it);
+    }
+
+    void PagedListLoader::run(const std::stop_token stop)
+    {
+        while (true)
+        {
+            size_t   page;
+            uint64_t gen;
+            {
+                std::unique_lock lock(mutex);
+                if (!condition.wait(lock, stop, [this] { return !queue.empty(); })) return;
+
+                page = queue.back();
+                gen  = generation;
+                queue.pop_back();
+            }
+
+            // Fetch strings without holding the lock. This is the slow part.
+            const auto size  = source->getSize();
+            const auto first = page * pageSize;
+            const auto last  = std::min(first + pageSize, size);
+
+            std::vector<std::string> strings;
+            strings.reserve(last > first ? last - first : 0);
+            for (auto i = first; i < last; i++) strings.emplace_back(source->getString(i));
+
+            {
+                std::scoped_lock lock(mutex);
+                if (gen == generation) arrived.emplace_back(page, std::move(strings));
+            }
+        }
+    }
+}  // namespace floah
@@ -4,9 +4,17 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <format>
+#include <iterator>
 #include <ranges>
 
+#if FLOAH_WIDGET_PARALLEL_EXECUTION
+#include <exception>
+#include <execution>
+#include <mutex>
+#endif
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -14,6 +22,57 @@
 #include "common/enum_classes.h"
 #include "floah-common/floah_error.h"
 #include "math/include_all.h"
+#include "sol/scenegraph/node.h"
+#include "sol/scenegraph/drawable/mesh_node.h"
+#include "sol/scenegraph/forward/forward_material_node.h"
+
+namespace
+{
+    [[nodiscard]] bool equal(const floah::Length& lhs, const floah::Length& rhs) noexcept
+    {
+        // An absolute and a relative length with the same value are not equal.
+        return lhs.isAbsolute() == rhs.isAbsolute() && lhs.get() == rhs.get();
+    }
+
+    [[nodiscard]] bool equal(const floah::Size& lhs, const floah::Size& rhs) noexcept
+    {
+        return equal(lhs.getWidth(), rhs.getWidth()) && equal(lhs.getHeight(), rhs.getHeight());
+    }
+
+    template<typename T>
+    [[nodiscard]] bool equal(const T& lhs, const T& rhs) noexcept
+    {
+        return lhs.x0 == rhs.x0 && lhs.y0 == rhs.y0 && lhs.x1 == rhs.x1 && lhs.y1 == rhs.y1;
+    }
+
+    /**
+     * \brief Apply f to all elements concurrently, or serially if the module was built without parallel algorithms.
+     * If f throws, the first exception is rethrown after all elements were visited.
+     */
+    template<typename It, typename F>
+    void parallelForEach(It first, It last, F f)
+    {
+#if FLOAH_WIDGET_PARALLEL_EXECUTION
+        // An exception escaping a parallel algorithm calls std::terminate, so it is caught and rethrown here.
+        std::mutex         mutex;
+        std::exception_ptr exception;
+        std::for_each(std::execution::par, first, last, [&](auto&& elem) {
+            try
+            {
+                f(elem);
+            }
+            catch (...)
+            {
+                std::scoped_lock lock(mutex);
+                if (!exception) exception = std::current_exception();
+            }
+        });
+        if (exception) std::rethrow_exception(exception);
+#else
+        std::for_each(first, last, f);
+#endif
+    }
+}  // namespace
 
 namespace floah
 {
@@ -21,12 +80,17 @@ namespace floah
     // Constructors.
     ////////////////////////////////////////////////////////////////
 
-    Panel::Panel(InputContext& context) : InputElement(), layout(std::make_unique<Layout>()), inputContext(&context)
+    Panel::Panel(InputContext& context) :
+        InputElement(),
+        layout(std::make_unique<Layout>()),
+        textMeshCache(std::make_shared<TextMeshCache>()),
+        nodePool(destructionQueue),
+        inputContext(&context)
     {
         inputContext->addElement(*this);
     }
 
-    Panel::~Panel() noexcept = default;
+    Panel::~Panel() noexcept { release(); }
 
     ////////////////////////////////////////////////////////////////
     // Getters.
@@ -48,11 +112,132 @@ namespace floah
 
     const sol::Node* Panel::getPanelNode() const noexcept { return nullptr; }
 
+    sol::ForwardMaterialNode& Panel::getWidgetMaterialNode(IScenegraphGenerator&         generator,
+                                                           sol::ForwardMaterialInstance* material)
+    {
+        if (!materialNodes.root) materialNodes.root = &generator.createWidgetNode(getPanelNode());
+
+        auto& node = materialNodes.widget[material];
+        if (!node)
+        {
+            node = &materialNodes.root->addChild(std::make_unique<sol::ForwardMaterialNode>());
+            node->setMaterial(material);
+        }
+
+        return *node;
+    }
+
+    sol::Node& Panel::getTextMaterialNode(IScenegraphGenerator& generator, sol::ForwardMaterialInstance& material)
+    {
+        if (!materialNodes.root) materialNodes.root = &generator.createWidgetNode(getPanelNode());
+
+        auto& node = materialNodes.text[&material];
+        if (!node) node = &generator.createTextMaterialNode(*materialNodes.root, material);
+
+        return *node;
+    }
+
+    MeshCache& Panel::getMeshCache() noexcept { return meshCache; }
+
+    const MeshCache& Panel::getMeshCache() const noexcept { return meshCache; }
+
+    TextMeshCache& Panel::getTextMeshCache() noexcept { return *textMeshCache; }
+
+    const TextMeshCache& Panel::getTextMeshCache() const noexcept { return *textMeshCache; }
+
+    const InstanceBatches& Panel::getInstanceBatches() const noexcept { return instanceBatches; }
+
+    bool Panel::isInstancingEnabled() const noexcept { return instancing; }
+
+    const StaticBatches& Panel::getStaticBatches() const noexcept { return staticBatches; }
+
+    bool Panel::isBatchingEnabled() const noexcept { return batching; }
+
+    IBatchGenerator* Panel::getBatchGenerator() const noexcept { return batchGenerator; }
+
+    NodePool& Panel::getNodePool() noexcept { return nodePool; }
+
+    const NodePool& Panel::getNodePool() const noexcept { return nodePool; }
+
+    Panel::StaleData Panel::getStaleData() const noexcept { return staleData; }
+
+    Panel::ExecutionMode Panel::getExecutionMode() const noexcept { return executionMode; }
+
     ////////////////////////////////////////////////////////////////
     // Setters.
     ////////////////////////////////////////////////////////////////
 
-    void Panel::setStylesheet(Stylesheet* sheet) noexcept { stylesheet = sheet; }
+    void Panel::setStylesheet(Stylesheet* sheet)
+    {
+        if (stylesheet == sheet) return;
+        const Stylesheet* sheets[] = {stylesheet, sheet};
+        styleCache.invalidate(sheets);
+        stylesheet = sheet;
+
+        // Everything can depend on the panel stylesheet. The widget stylesheets did not change, so only the resolved
+        // styles are invalidated.
+        staleData |= StaleData::All;
+        for (const auto& w : widgets) w->markStyleStale();
+    }
+
+    void Panel::notifyStylesheetChanged(const Stylesheet& sheet, const std::span<const StyleKey> keys)
+    {
+        if (keys.empty()) return;
+        styleCache.invalidate(sheet, keys);
+
+        // Widgets fall back to the panel stylesheet, so they can all depend on it.
+        const bool isPanelSheet = stylesheet == &sheet;
+        for (const auto& w : widgets)
+        {
+            if (!isPanelSheet && w->stylesheet != &sheet) continue;
+
+            auto data = Widget::StaleData::None;
+            for (const auto key : keys) data |= w->getStyleDependency(key);
+            if (data == Widget::StaleData::None) continue;
+
+            w->styleStale = true;
+            w->markStale(data);
+        }
+    }
+
+    void Panel::setTextMeshCache(std::shared_ptr<TextMeshCache> cache)
+    {
+        if (!cache) throw FloahError("Cannot set text mesh cache. Cache is null.");
+        if (!widgets.empty()) throw FloahError("Cannot set text mesh cache. Panel already has widgets.");
+
+        // Destroyed widgets can still have meshes queued for release into the old cache.
+        destructionQueue.flush();
+        textMeshCache = std::move(cache);
+    }
+
+    void Panel::setInstancingEnabled(const bool enabled)
+    {
+        if (!widgets.empty()) throw FloahError("Cannot set instancing. Panel already has widgets.");
+        if (enabled && !batchGenerator) throw FloahError("Cannot enable instancing. Panel has no batch generator.");
+        instancing = enabled;
+    }
+
+    void Panel::setBatchingEnabled(const bool enabled)
+    {
+        if (!widgets.empty()) throw FloahError("Cannot set batching. Panel already has widgets.");
+        if (enabled && !batchGenerator) throw FloahError("Cannot enable batching. Panel has no batch generator.");
+        batching = enabled;
+    }
+
+    void Panel::setBatchGenerator(IBatchGenerator* generator)
+    {
+        if (!widgets.empty()) throw FloahError("Cannot set batch generator. Panel already has widgets.");
+        batchGenerator = generator;
+        if (!batchGenerator)
+        {
+            instancing = false;
+            batching   = false;
+        }
+    }
+
+    void Panel::markStale(const StaleData data) noexcept { staleData |= data; }
+
+    void Panel::setExecutionMode(const ExecutionMode mode) noexcept { executionMode = mode; }
 
     ////////////////////////////////////////////////////////////////
     // Layers.
@@ -93,65 +278,348 @@ namespace floah
     // Widgets.
     ////////////////////////////////////////////////////////////////
 
+    Widget* Panel::getWidget(const WidgetHandle handle) noexcept
+    {
+        auto* w = widgets.find(handle);
+        return w ? w->get() : nullptr;
+    }
+
+    const Widget* Panel::getWidget(const WidgetHandle handle) const noexcept
+    {
+        const auto* w = widgets.find(handle);
+        return w ? w->get() : nullptr;
+    }
+
     void Panel::destroyWidget(Widget& widget)
     {
         if (&widget.getPanel() != this) throw FloahError("Cannot destroy widget. It is not part of this panel.");
 
         inputContext->removeElement(widget);
 
-        const auto it = std::ranges::find_if(widgets, [&widget](const auto& w) { return w.get() == &widget; });
-        widgets.erase(it);
+        // Handles left in the work queues no longer resolve after this and are skipped when the queues are drained.
+        widgets.erase(widget.handle);
+
+        // The batches lost the sub-ranges and instances of the widget.
+        if (batching || instancing) staleData |= StaleData::Scenegraph;
+    }
+
+    void Panel::release()
+    {
+        // Widget nodes are children of the material nodes. Destroy the widgets and empty the node pool first, so that
+        // their nodes are queued before the material nodes and the queue never detaches a node that was destroyed
+        // together with its parent.
+        while (!widgets.empty()) destroyWidget(**std::prev(widgets.end()));
+        nodePool.clear();
+        destroyEmptyBatches();
+        if (materialNodes.root) destructionQueue.enqueue(*materialNodes.root);
+        materialNodes = {};
+
+        // Detaches all nodes, then destroys the meshes that are no longer used.
+        destructionQueue.flush();
     }
 
     void Panel::addWidgetImpl(WidgetPtr widget, Layer* layer)
     {
-        auto& ref = *widgets.emplace_back(std::move(widget));
-        ref.panel = this;
-        ref.layer = layer;
+        auto& ref  = *widget;
+        ref.handle = widgets.insert(std::move(widget));
+        ref.panel  = this;
+        ref.layer  = layer;
+        styleCache.invalidate(ref.stylesheet);
         inputContext->addElement(ref);
+        if (ref.polling) pollingWidgets.push_back(ref.handle);
+        enqueueStaleWidget(ref);
+    }
+
+    void Panel::addWidgetsImpl(std::vector<WidgetPtr> ws, Layer* layer)
+    {
+        widgets.reserve(widgets.size() + ws.size());
+        staleWidgets.layout.reserve(staleWidgets.layout.size() + ws.size());
+        staleWidgets.geometry.reserve(staleWidgets.geometry.size() + ws.size());
+        staleWidgets.scenegraph.reserve(staleWidgets.scenegraph.size() + ws.size());
+
+        // Widgets mostly share a few stylesheets. Each of them is invalidated once below.
+        std::vector<const Stylesheet*> sheets;
+
+        // InputContext has no batch registration, so elements are still added one by one.
+        for (auto& widget : ws)
+        {
+            auto& ref  = *widget;
+            ref.handle = widgets.insert(std::move(widget));
+            ref.panel  = this;
+            ref.layer  = layer;
+            if (ref.stylesheet && std::ranges::find(sheets, ref.stylesheet) == sheets.end())
+                sheets.push_back(ref.stylesheet);
+            inputContext->addElement(ref);
+            if (ref.polling) pollingWidgets.push_back(ref.handle);
+        }
+
+        styleCache.invalidate(sheets);
+
+        // Inserted widgets are at the back of the dense storage. Mark them stale in one go.
+        for (auto& widget : widgets | std::views::drop(widgets.size() - ws.size())) enqueueStaleWidget(*widget);
+    }
+
+    void Panel::enqueueStaleWidget(Widget& widget)
+    {
+        const auto missing = widget.staleData & ~widget.queuedData;
+        if (any(missing & Widget::StaleData::Layout)) staleWidgets.layout.push_back(widget.handle);
+        if (any(missing & Widget::StaleData::Geometry)) staleWidgets.geometry.push_back(widget.handle);
+        if (any(missing & Widget::StaleData::Scenegraph)) staleWidgets.scenegraph.push_back(widget.handle);
+        widget.queuedData |= missing;
+    }
+
+    std::vector<Widget*> Panel::takeStaleWidgets(std::vector<WidgetHandle>& queue, const Widget::StaleData stage)
+    {
+        std::vector<Widget*> ws;
+        ws.reserve(queue.size());
+
+        for (const auto handle : queue)
+        {
+            // Widget was destroyed since it was queued.
+            auto* w = getWidget(handle);
+            if (!w) continue;
+
+            // Widgets may have been regenerated outside of the panel since they were queued.
+            w->queuedData = w->queuedData & ~stage;
+            if (any(w->staleData & stage)) ws.push_back(w);
+        }
+
+        queue.clear();
+        return ws;
+    }
+
+    void Panel::requeueStaleWidgets(const std::span<Widget* const> ws)
+    {
+        for (auto* w : ws) enqueueStaleWidget(*w);
     }
 
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
-    void Panel::generatePanelLayout() { blocks = layout->generate(); }
+    void Panel::update(sol::MeshManager& meshManager, FontMap& fontMap, IScenegraphGenerator& generator)
+    {
+        // Polled widgets can mark themselves stale for this frame.
+        for (size_t i = 0; i < pollingWidgets.size();)
+        {
+            auto* w = getWidget(pollingWidgets[i]);
+            if (w && w->polling)
+            {
+                w->poll();
+                i++;
+                continue;
+            }
+
+            // Widget was destroyed or disabled polling.
+            pollingWidgets[i] = pollingWidgets.back();
+            pollingWidgets.pop_back();
+        }
+
+        if (!equal(layout->getSize(), generatedLayout.size) || !equal(layout->getOffset(), generatedLayout.offset))
+            staleData |= StaleData::Layout;
+
+        if (any(staleData & StaleData::Layout)) generatePanelLayout();
+        if (!staleWidgets.layout.empty()) generateWidgetLayouts();
+        if (any(staleData & StaleData::Geometry) || !staleWidgets.geometry.empty())
+            generateGeometry(meshManager, fontMap);
+        if (any(staleData & StaleData::Scenegraph) || !staleWidgets.scenegraph.empty()) generateScenegraph(generator);
+
+        // Released after the stages, so that new widgets that use the same meshes take them over instead.
+        destructionQueue.flush();
+    }
+
+    void Panel::generatePanelLayout()
+    {
+        // Keep old blocks around to determine which widgets are affected.
+        auto oldBlocks     = std::move(blocks);
+        auto oldBlockIndex = std::move(blockIndex);
+
+        blocks = layout->generate();
+
+        blockIndex.clear();
+        blockIndex.reserve(blocks.size());
+        for (size_t i = 0; i < blocks.size(); i++) blockIndex.try_emplace(blocks[i].id, i);
+
+        generatedLayout.size   = layout->getSize();
+        generatedLayout.offset = layout->getOffset();
+        staleData              = staleData & ~StaleData::Layout;
+
+        // Only widgets whose block was added or changed bounds need to follow it. If a block only moved, the widget
+        // layout can be translated instead of regenerated.
+        for (const auto& w : widgets)
+        {
+            const auto* elem = w->getPanelLayoutElement();
+            if (!elem) continue;
+
+            const auto* block = findBlock(*elem);
+            if (!block) continue;
+
+            const auto it = oldBlockIndex.find(elem->getId());
+            if (it == oldBlockIndex.end())
+            {
+                w->markStale(Widget::StaleData::All);
+                continue;
+            }
+
+            const auto& oldBounds = oldBlocks[it->second].bounds;
+            if (equal(oldBounds, block->bounds)) continue;
+
+            if (oldBounds.width() == block->bounds.width() && oldBounds.height() == block->bounds.height() &&
+                !any(w->getStaleData() & Widget::StaleData::Layout))
+                w->translateLayout(math::int2(block->bounds.x0 - oldBounds.x0, block->bounds.y0 - oldBounds.y0));
+            else
+                w->markStale(Widget::StaleData::All);
+        }
+    }
 
     void Panel::generateWidgetLayouts()
     {
-        for (auto& w : widgets | std::views::filter([](const auto& widget) {
-                           return any(widget->getStaleData() & Widget::StaleData::Layout);
-                       }))
+        const auto ws = takeStaleWidgets(staleWidgets.layout, Widget::StaleData::Layout);
+        try
+        {
+            generateWidgetLayoutsImpl(ws);
+        }
+        catch (...)
+        {
+            requeueStaleWidgets(ws);
+            throw;
+        }
+    }
+
+    void Panel::generateWidgetLayoutsImpl(const std::span<Widget* const> ws)
+    {
+        std::vector<std::pair<Widget*, const Block*>> work;
+
+        for (auto* w : ws)
         {
             // Look for element in panel layout widget is attached to.
-            const auto it = std::ranges::find_if(blocks, [&](const Block& block) {
-                auto* elem = w->getPanelLayoutElement();
-                if (!elem) return false;
-                return elem->getId() == block.id;
-            });
-
-            // If widget was attached to an element, generate its layout.
-            if (it != blocks.end())
-                w->generateLayout(Size(Length(it->bounds.width()), Length(it->bounds.height())),
-                                  Size(Length(it->bounds.x0), Length(it->bounds.y0)));
+            const auto* elem  = w->getPanelLayoutElement();
+            const auto* block = elem ? findBlock(*elem) : nullptr;
+
+            // If widget was attached to an element, generate its layout. Otherwise, keep it queued.
+            if (block)
+            {
+                // The style cache is shared, so resolve styles before going concurrent.
+                w->updateStyle();
+                w->prepareLayout();
+                work.emplace_back(w, block);
+            }
+            else
+                enqueueStaleWidget(*w);
             // TODO: Clear layout otherwise?
         }
+
+        // Each widget only writes to its own layout, so they can be generated independently.
+        const auto generate = [](const std::pair<Widget*, const Block*>& item) {
+            const auto& [w, block] = item;
+            w->generateLayout(Size(Length(block->bounds.width()), Length(block->bounds.height())),
+                              Size(Length(block->bounds.x0), Length(block->bounds.y0)));
+        };
+
+        if (executionMode == ExecutionMode::Parallel)
+            parallelForEach(work.begin(), work.end(), generate);
+        else
+            std::ranges::for_each(work, generate);
     }
 
     void Panel::generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap)
     {
-        for (const auto& w : widgets | std::views::filter([](const auto& widget) {
-                                 return any(widget->getStaleData() & Widget::StaleData::Geometry);
-                             }))
-            w->generateGeometry(meshManager, fontMap);
+        // Geometry is always generated serially. The floah-viz generators build vertices directly in the mesh manager,
+        // which is shared by all widgets, so there is no concurrent work left once the generators are configured.
+        const auto ws = takeStaleWidgets(staleWidgets.geometry, Widget::StaleData::Geometry);
+        try
+        {
+            for (auto* w : ws) w->generateGeometry(meshManager, fontMap);
+        }
+        catch (...)
+        {
+            requeueStaleWidgets(ws);
+            throw;
+        }
+
+        staleData = staleData & ~StaleData::Geometry;
     }
 
     void Panel::generateScenegraph(IScenegraphGenerator& generator)
     {
-        for (const auto& w : widgets | std::views::filter([](const auto& widget) {
-                                 return any(widget->getStaleData() & Widget::StaleData::Scenegraph);
-                             }))
-            w->generateScenegraph(generator);
+        const auto ws = takeStaleWidgets(staleWidgets.scenegraph, Widget::StaleData::Scenegraph);
+        try
+        {
+            for (auto* w : ws) w->generateScenegraph(generator);
+        }
+        catch (...)
+        {
+            requeueStaleWidgets(ws);
+            throw;
+        }
+
+        if (batching || instancing) generateBatchNodes(generator);
+
+        staleData = staleData & ~StaleData::Scenegraph;
+    }
+
+    void Panel::generateBatchNodes(IScenegraphGenerator& generator)
+    {
+        destroyEmptyBatches();
+
+        for (const auto& batch : staticBatches.getBatches())
+        {
+            auto& entry = staticBatchNodes[batch.get()];
+            if (!entry.node)
+            {
+                entry.mesh = &batchGenerator->createStaticBatchMesh(*batch);
+                entry.node = &getWidgetMaterialNode(generator, batch->getMaterial())
+                                .addChild(std::make_unique<sol::MeshNode>(*entry.mesh));
+            }
+            else if (const auto [first, last] = batch->getDirtyRange(); first != last)
+                batchGenerator->updateStaticBatchMesh(*entry.mesh, *batch);
+
+            batch->clearDirtyRange();
+        }
+
+        for (const auto& batch : instanceBatches.getBatches())
+        {
+            auto& node = instanceBatchNodes[batch.get()];
+            if (!node)
+            {
+                auto& parent = getWidgetMaterialNode(generator, batch->getMaterial());
+                node         = &batchGenerator->createInstanceBatchNode(parent, *batch);
+            }
+            else if (const auto [first, last] = batch->getDirtyRange(); first != last)
+                batchGenerator->updateInstanceBatchNode(*node, *batch);
+
+            batch->clearDirtyRange();
+        }
+    }
+
+    void Panel::destroyEmptyBatches()
+    {
+        for (const auto& batch : staticBatches.takeEmpty())
+        {
+            const auto it = staticBatchNodes.find(batch.get());
+            if (it == staticBatchNodes.end()) continue;
+
+            // The node is detached before its mesh is destroyed.
+            destructionQueue.enqueue(*it->second.node);
+            destructionQueue.enqueue(*it->second.mesh);
+            staticBatchNodes.erase(it);
+        }
+
+        for (const auto& batch : instanceBatches.takeEmpty())
+        {
+            const auto it = instanceBatchNodes.find(batch.get());
+            if (it == instanceBatchNodes.end()) continue;
+
+            // The mesh is shared through the mesh cache and released by the widgets.
+            destructionQueue.enqueue(*it->second);
+            instanceBatchNodes.erase(it);
+        }
+    }
+
+    const Block* Panel::findBlock(const LayoutElement& element) const noexcept
+    {
+        const auto it = blockIndex.find(element.getId());
+        return it == blockIndex.end() ? nullptr : &blocks[it->second];
     }
 
     ////////////////////////////////////////////////////////////////
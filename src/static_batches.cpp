@@ -0,0 +1,264 @@
+#include "floah-widget/static_batches.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace
+{
+    void appendQuad(std::vector<floah::StaticVertex>& vertices,
+                    const math::float2                lower,
+                    const math::float2                upper,
+                    const floah::StaticGeometry&      geometry)
+    {
+        const auto vertex = [&](const float x, const float y) {
+            vertices.push_back({.position = math::float3(x, y, 0.0f) + geometry.offset, .color = geometry.shape.color});
+        };
+
+        vertex(lower[0], lower[1]);
+        vertex(upper[0], lower[1]);
+        vertex(upper[0], upper[1]);
+        vertex(lower[0], lower[1]);
+        vertex(upper[0], upper[1]);
+        vertex(lower[0], upper[1]);
+    }
+
+    /**
+     * \brief Append the triangles of a shape. A filled rectangle is a single quad, an outline is a ring of four quads
+     * that are as wide as the margin.
+     */
+    void appendVertices(std::vector<floah::StaticVertex>& vertices, const floah::StaticGeometry& geometry)
+    {
+        const auto& shape = geometry.shape;
+        if (shape.fillMode == floah::RectangleGenerator::FillMode::Fill)
+        {
+            appendQuad(vertices, shape.lower, shape.upper, geometry);
+            return;
+        }
+
+        const auto halfWidth  = 0.5f * (shape.upper[0] - shape.lower[0]);
+        const auto halfHeight = 0.5f * (shape.upper[1] - shape.lower[1]);
+        const auto margin     = std::clamp(shape.margin.get(), 0.0f, std::min(halfWidth, halfHeight));
+        const auto innerLower = math::float2(shape.lower[0] + margin, shape.lower[1] + margin);
+        const auto innerUpper = math::float2(shape.upper[0] - margin, shape.upper[1] - margin);
+
+        // Bottom, top, left and right strips.
+        const auto x0 = shape.lower[0], x1 = innerLower[0], x2 = innerUpper[0], x3 = shape.upper[0];
+        const auto y0 = shape.lower[1], y1 = innerLower[1], y2 = innerUpper[1], y3 = shape.upper[1];
+        appendQuad(vertices, math::float2(x0, y0), math::float2(x3, y1), geometry);
+        appendQuad(vertices, math::float2(x0, y2), math::float2(x3, y3), geometry);
+        appendQuad(vertices, math::float2(x0, y1), math::float2(x1, y2), geometry);
+        appendQuad(vertices, math::float2(x2, y1), math::float2(x3, y2), geometry);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    StaticBatch::StaticBatch(sol::ForwardMaterialInstance* batchMaterial, const int32_t batchLayer) :
+        material(batchMaterial), layer(batchLayer)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    sol::ForwardMaterialInstance* StaticBatch::getMaterial() const noexcept { return material; }
+
+    int32_t StaticBatch::getLayer() const noexcept { return layer; }
+
+    std::span<const StaticSubRange> StaticBatch::getSubRanges() const noexcept
+    {
+        return {subRanges.begin(), subRanges.end()};
+    }
+
+    std::span<const StaticVertex> StaticBatch::getVertices() const noexcept { return vertices; }
+
+    size_t StaticBatch::size() const noexcept { return subRanges.size(); }
+
+    std::pair<size_t, size_t> StaticBatch::getDirtyRange() const noexcept { return dirty; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void StaticBatch::clearDirtyRange() noexcept { dirty = {0, 0}; }
+
+    ////////////////////////////////////////////////////////////////
+    // Sub-ranges.
+    ////////////////////////////////////////////////////////////////
+
+    SlotMapHandle StaticBatch::add(const StaticGeometry& geometry)
+    {
+        StaticSubRange subRange{.geometry = geometry, .firstVertex = vertices.size()};
+        appendVertices(vertices, geometry);
+        subRange.vertexCount = vertices.size() - subRange.firstVertex;
+        markDirty(subRange.firstVertex, vertices.size());
+
+        return subRanges.insert(subRange);
+    }
+
+    void StaticBatch::update(StaticSubRange& subRange, const StaticGeometry& geometry)
+    {
+        subRange.geometry = geometry;
+
+        // Regenerate the vertices into the end of the list, and move them into place if their number did not change.
+        const auto end = vertices.size();
+        appendVertices(vertices, geometry);
+        if (vertices.size() - end == subRange.vertexCount)
+        {
+            std::move(vertices.begin() + static_cast<ptrdiff_t>(end),
+                      vertices.end(),
+                      vertices.begin() + static_cast<ptrdiff_t>(subRange.firstVertex));
+            vertices.resize(end);
+            markDirty(subRange.firstVertex, subRange.firstVertex + subRange.vertexCount);
+            return;
+        }
+
+        // All following sub-ranges shift.
+        vertices.resize(end);
+        rebuild(static_cast<size_t>(&subRange - &*subRanges.begin()));
+    }
+
+    void StaticBatch::erase(const SlotMapHandle handle)
+    {
+        const auto* subRange = subRanges.find(handle);
+        if (!subRange) return;
+
+        // The last sub-range is moved into the position of the erased one, shifting all sub-ranges in between.
+        const auto index = static_cast<size_t>(subRange - &*subRanges.begin());
+        subRanges.erase(handle);
+        rebuild(index);
+    }
+
+    void StaticBatch::rebuild(const size_t index)
+    {
+        // Sub-ranges are merged in order, so the vertices of the sub-ranges before the index stay where they are.
+        const auto oldSize = vertices.size();
+        const auto first   = getSubRanges().first(index);
+        vertices.resize(first.empty() ? 0 : first.back().firstVertex + first.back().vertexCount);
+        const auto start = vertices.size();
+
+        for (auto it = subRanges.begin() + static_cast<ptrdiff_t>(index); it != subRanges.end(); ++it)
+        {
+            it->firstVertex = vertices.size();
+            appendVertices(vertices, it->geometry);
+            it->vertexCount = vertices.size() - it->firstVertex;
+        }
+
+        markDirty(start, std::max(oldSize, vertices.size()));
+    }
+
+    void StaticBatch::markDirty(const size_t first, const size_t last) noexcept
+    {
+        if (first >= last) return;
+
+        if (dirty.first == dirty.second)
+            dirty = {first, last};
+        else
+            dirty = {std::min(dirty.first, first), std::max(dirty.second, last)};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::vector<std::unique_ptr<StaticBatch>>& StaticBatches::getBatches() const noexcept { return batches; }
+
+    ////////////////////////////////////////////////////////////////
+    // Geometry.
+    ////////////////////////////////////////////////////////////////
+
+    void StaticBatches::replace(StaticGeometryHandle&         handle,
+                                sol::ForwardMaterialInstance* material,
+                                const int32_t                 layer,
+                                const StaticGeometry&         geometry)
+    {
+        // Update sub-range in place.
+        if (handle.valid() && handle.batch->material == material && handle.batch->layer == layer)
+        {
+            auto& batch = *handle.batch;
+            if (auto* subRange = batch.subRanges.find(handle.handle))
+            {
+                // Widgets update their sub-range whenever their scenegraph is regenerated, which rarely changes it.
+                if (equal(subRange->geometry, geometry)) return;
+
+                batch.update(*subRange, geometry);
+                return;
+            }
+        }
+
+        // Move sub-range to another batch.
+        const Key key{.material = material, .layer = layer};
+        auto      it = batchIndex.find(key);
+        if (it == batchIndex.end())
+        {
+            it = batchIndex.try_emplace(key, batches.size()).first;
+            batches.emplace_back(std::make_unique<StaticBatch>(material, layer));
+        }
+
+        auto&                      batch = *batches[it->second];
+        const StaticGeometryHandle newHandle{.batch = &batch, .handle = batch.add(geometry)};
+        remove(handle);
+        handle = newHandle;
+    }
+
+    void StaticBatches::remove(StaticGeometryHandle& handle)
+    {
+        if (!handle.valid()) return;
+
+        auto&      batch = *handle.batch;
+        const auto slot  = std::exchange(handle, {}).handle;
+        batch.erase(slot);
+    }
+
+    std::vector<std::unique_ptr<StaticBatch>> StaticBatches::takeEmpty()
+    {
+        std::vector<std::unique_ptr<StaticBatch>> empty;
+        for (size_t index = 0; index < batches.size();)
+        {
+            if (batches[index]->size() > 0)
+            {
+                index++;
+                continue;
+            }
+
+            // Take empty batch by moving the last batch into its position.
+            auto& batch = *batches[index];
+            batchIndex.erase(Key{.material = batch.material, .layer = batch.layer});
+            empty.emplace_back(std::move(batches[index]));
+            if (index != batches.size() - 1)
+            {
+                auto& last = *batches.back();
+                batchIndex.insert_or_assign(Key{.material = last.material, .layer = last.layer}, index);
+                batches[index] = std::move(batches.back());
+            }
+            batches.pop_back();
+        }
+
+        return empty;
+    }
+
+    bool StaticBatches::equal(const StaticGeometry& lhs, const StaticGeometry& rhs) noexcept
+    {
+        const auto& a = lhs.shape;
+        const auto& b = rhs.shape;
+        return a.lower == b.lower && a.upper == b.upper && a.fillMode == b.fillMode &&
+               a.margin.get() == b.margin.get() && a.color == b.color && lhs.offset == rhs.offset;
+    }
+
+    size_t StaticBatches::KeyHash::operator()(const Key& key) const noexcept
+    {
+        auto h = std::hash<const void*>{}(key.material);
+        h ^= std::hash<int32_t>{}(key.layer) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        return h;
+    }
+}  // namespace floah
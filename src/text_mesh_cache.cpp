@@ -0,0 +1,133 @@
+#include "floah-widget/text_mesh_cache.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <ranges>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/flat_mesh.h"
+#include "sol/mesh/mesh_manager.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    TextMeshCache::TextMeshCache(const size_t cap) : memoryCap(cap) {}
+
+    TextMeshCache::~TextMeshCache() noexcept
+    {
+        for (const auto& entry : entries | std::views::values)
+            entry.mesh->getMeshManager().destroyMesh(entry.mesh->getUuid());
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t TextMeshCache::size() const noexcept { return entries.size(); }
+
+    size_t TextMeshCache::getMemoryUsage() const noexcept { return memoryUsage; }
+
+    size_t TextMeshCache::getMemoryCap() const noexcept { return memoryCap; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void TextMeshCache::setMemoryCap(const size_t cap)
+    {
+        memoryCap = cap;
+        evict();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Meshes.
+    ////////////////////////////////////////////////////////////////
+
+    sol::IMesh& TextMeshCache::acquire(TextGenerator& generator, const Generator::Params& params)
+    {
+        auto it = entries.find(KeyView{generator.text, &params.fontMap, &params.meshManager});
+        if (it == entries.end())
+        {
+            auto&      mesh = generator.generate(params);
+            const auto size = generator.text.size() * estimated_character_size;
+            Key        key{generator.text, &params.fontMap, &params.meshManager};
+            Entry      entry{.mesh = &mesh, .references = 0, .size = size, .unused = unused.end()};
+            it = entries.try_emplace(std::move(key), entry).first;
+            keys.try_emplace(&mesh, &it->first);
+            memoryUsage += it->second.size;
+        }
+        else if (it->second.references == 0)
+            unused.erase(it->second.unused);
+
+        it->second.references++;
+        auto& mesh = *it->second.mesh;
+
+        // The new mesh can push usage over the cap.
+        evict();
+
+        return mesh;
+    }
+
+    void TextMeshCache::release(const sol::IMesh* mesh)
+    {
+        if (!mesh) return;
+
+        const auto keyIt = keys.find(mesh);
+        if (keyIt == keys.end()) return;
+
+        auto& entry = entries.find(*keyIt->second)->second;
+        if (--entry.references > 0) return;
+
+        entry.unused = unused.insert(unused.end(), mesh);
+        evict();
+    }
+
+    bool TextMeshCache::replace(sol::IMesh*& mesh, TextGenerator& generator, const Generator::Params& params)
+    {
+        auto* old = mesh;
+        mesh      = &acquire(generator, params);
+        release(old);
+        return mesh != old;
+    }
+
+    void TextMeshCache::trim()
+    {
+        const auto cap = std::exchange(memoryCap, 0);
+        evict();
+        memoryCap = cap;
+    }
+
+    void TextMeshCache::evict()
+    {
+        while (memoryUsage > memoryCap && !unused.empty())
+        {
+            const auto* mesh  = unused.front();
+            const auto  keyIt = keys.find(mesh);
+            const auto  it    = entries.find(*keyIt->second);
+
+            unused.pop_front();
+            keys.erase(keyIt);
+            memoryUsage -= it->second.size;
+            it->second.mesh->getMeshManager().destroyMesh(it->second.mesh->getUuid());
+            entries.erase(it);
+        }
+    }
+
+    size_t TextMeshCache::KeyHash::operator()(const KeyView& key) const noexcept
+    {
+        auto h = std::hash<std::string_view>{}(key.text);
+        h ^= std::hash<const void*>{}(key.fontMap) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        h ^= std::hash<const void*>{}(key.meshManager) + 0x9E3779B9 + (h << 6) + (h >> 2);
+        return h;
+    }
+}  // namespace floah
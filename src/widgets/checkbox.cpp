@@ -4,7 +4,9 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <ranges>
+#include <typeinfo>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -39,9 +41,21 @@ namespace floah
     Checkbox::~Checkbox() noexcept
     {
         if (dataSource) dataSource->removeDataListener(*this);
-        // TODO: Destroy any allocated meshes, nodes, etc.
-        // if (meshes.box) meshManager.destroyMesh(meshes.box->getUuid());
-        // if (meshes.checkmark) meshManager.destroyMesh(meshes.checkmark->getUuid());
+        // Nodes are pooled for reuse by a new checkbox. They must no longer refer to the meshes released below.
+        if (nodes.labelTransform) releaseNodes();
+
+        // Meshes are released after the nodes that refer to them were detached, when the panel is updated.
+        releaseMesh(meshes.box);
+        releaseMesh(meshes.highlight);
+        releaseMesh(meshes.checkmark);
+        releaseTextMesh(meshes.label);
+        if (auto* batches = getInstanceBatches())
+        {
+            batches->destroy(instances.box);
+            batches->destroy(instances.highlight);
+            batches->destroy(instances.checkmark);
+        }
+        if (auto* batches = getStaticBatches()) batches->remove(batchedBox);
     }
 
     ////////////////////////////////////////////////////////////////
@@ -62,14 +76,14 @@ namespace floah
 
     void Checkbox::setDataSource(IBoolDataSource* source)
     {
-        if (replaceDataSource(&dataSource, source)) staleData |= StaleData::Scenegraph;
+        if (replaceDataSource(&dataSource, source)) markStale(StaleData::Scenegraph);
     }
 
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
-    void Checkbox::generateLayout(Size size, Size offset)
+    void Checkbox::prepareLayout()
     {
         // Create layout elements if they do not exist.
         if (!elements.root)
@@ -77,121 +91,190 @@ namespace floah
             elements.root  = &layout->setRoot(std::make_unique<HorizontalFlow>());
             elements.box   = &elements.root->append(std::make_unique<LayoutElement>());
             elements.label = &elements.root->append(std::make_unique<LayoutElement>());
+
+            bindLayoutBlock(*elements.box, blocks.box);
+            bindLayoutBlock(*elements.label, blocks.label);
         }
+    }
+
+    void Checkbox::generateLayout(Size size, Size offset)
+    {
+        prepareLayout();
+        updateStyle();
 
         // Style layout elements.
         elements.root->getSize().setWidth(Length(1.0f));
         elements.root->getSize().setHeight(Length(1.0f));
 
-        elements.box->getSize().setWidth(getBoxWidth());
-        elements.box->getSize().setHeight(getBoxHeight());
-        elements.box->getOuterMargin() = getBoxMargin();
+        elements.box->getSize().setWidth(style.boxWidth);
+        elements.box->getSize().setHeight(style.boxHeight);
+        elements.box->getOuterMargin() = style.boxMargin;
 
-        elements.label->getSize().setWidth(getLabelWidth());
-        elements.label->getSize().setHeight(getLabelHeight());
-        elements.label->getOuterMargin() = getLabelMargin();
+        elements.label->getSize().setWidth(style.labelWidth);
+        elements.label->getSize().setHeight(style.labelHeight);
+        elements.label->getOuterMargin() = style.labelMargin;
 
         Widget::generateLayout(size, offset);
-
-        // Get blocks for relevant elements.
-        auto it =
-          std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == elements.box->getId(); });
-        blocks.box = &*it;
-        it = std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == elements.label->getId(); });
-        blocks.label = &*it;
     }
 
     void Checkbox::generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap)
     {
         if (!blocks.box) throw FloahError("Cannot generate geometry. Layout was not generated yet.");
+        updateStyle();
 
         Generator::Params params{.meshManager = meshManager, .fontMap = fontMap};
-        // TODO: Update meshes if they already exist.
-        {
-            RectangleGenerator gen;
-            gen.lower    = -0.5f * math::float2(math::min(blocks.box->bounds.width(), blocks.box->bounds.height()));
-            gen.upper    = -gen.lower;
-            gen.fillMode = RectangleGenerator::FillMode::Outline;
-            gen.margin   = Length(2);
-            gen.color    = getColor();
-            meshes.box   = &gen.generate(params);
-        }
-
-        {
-            RectangleGenerator gen;
-            gen.lower        = -0.5f * math::float2(math::min(blocks.box->bounds.width(), blocks.box->bounds.height()));
-            gen.upper        = -gen.lower;
-            gen.fillMode     = RectangleGenerator::FillMode::Fill;
-            gen.margin       = Length(2);
-            gen.color        = getColor();
-            meshes.highlight = &gen.generate(params);
-        }
-
-        {
-            CircleGenerator gen;
-            gen.fillMode = CircleGenerator::FillMode::Fill;
-            gen.radius = 0.5f * static_cast<float>(math::min(blocks.box->bounds.width(), blocks.box->bounds.height()));
-            meshes.checkmark = &gen.generate(params);
-        }
-
-        {
-            TextGenerator gen;
-            gen.text     = label;
-            meshes.label = &gen.generate(params);
-        }
+        const auto        size = static_cast<float>(math::min(blocks.box->bounds.width(), blocks.box->bounds.height()));
+
+        // Shapes are shared with identical widgets. A shape that did not change keeps its mesh.
+        auto& cache = *getMeshCache();
+        // Boxes that are batched are merged into the static batches instead.
+        if (getInstanceBatches() || !getStaticBatches()) cache.replace(meshes.box, getBoxShape(), params);
+        cache.replace(meshes.highlight,
+                      RectangleShape{.lower    = -0.5f * math::float2(size),
+                                     .upper    = 0.5f * math::float2(size),
+                                     .fillMode = RectangleGenerator::FillMode::Fill,
+                                     .margin   = Length(2),
+                                     .color    = style.color},
+                      params);
+        cache.replace(
+          meshes.checkmark, CircleShape{.fillMode = CircleGenerator::FillMode::Fill, .radius = 0.5f * size}, params);
+
+        // Labels are shared with widgets that have the same text.
+        TextGenerator labelGenerator;
+        labelGenerator.text = label;
+        getTextMeshCache()->replace(meshes.label, labelGenerator, params);
 
         staleData = staleData & ~StaleData::Geometry;
+
+        // Mesh nodes need to be pointed at the new meshes.
+        markStale(StaleData::Scenegraph);
     }
 
     void Checkbox::generateScenegraph(IScenegraphGenerator& generator)
     {
-        if (!meshes.box) throw FloahError("Cannot generate scenegraph. Geometry was not generated yet.");
+        if (!meshes.highlight) throw FloahError("Cannot generate scenegraph. Geometry was not generated yet.");
+        updateStyle();
+
+        // If instancing is enabled, the shapes are drawn from the instance batches of the panel and only the label
+        // gets nodes. Otherwise, if batching is enabled, the static box is drawn from the static batches.
+        auto* instanceBatches = getInstanceBatches();
+        auto* staticBatches   = instanceBatches ? nullptr : getStaticBatches();
 
+        // Nodes are attached to the material nodes of the materials they were created with. If the style changed the
+        // materials since, the nodes are pooled and replaced.
+        if (nodes.labelTransform && nodeMaterialsChanged(style.widgetMaterial, style.textMaterial)) releaseNodes();
 
-        if (!nodes.root)
+        // Adopt the nodes of a destroyed checkbox. They are pointed at the meshes of this one and moved below.
+        if (!nodes.labelTransform)
         {
-            nodes.root = &generator.createWidgetNode(panel->getPanelNode());
+            auto pooled = adoptNodes(typeid(Checkbox), style.widgetMaterial, style.textMaterial);
+            if (pooled.has_value())
+            {
+                nodes = std::any_cast<decltype(nodes)>(std::move(pooled));
+                staleData |= StaleData::Transform;
+            }
+        }
 
-            auto& widgetMtlNode = nodes.root->addChild(std::make_unique<sol::ForwardMaterialNode>());
-            widgetMtlNode.setMaterial(getWidgetMaterial());
+        if (!nodes.labelTransform)
+        {
+            // Material nodes are shared with the other widgets in the panel.
+            sol::ForwardMaterialNode* widgetMtlNode = nullptr;
+            if (!instanceBatches) widgetMtlNode = &panel->getWidgetMaterialNode(generator, style.widgetMaterial);
 
-            auto& textMtlNode = generator.createTextMaterialNode(*nodes.root, *getTextMaterial());
+            auto& textMtlNode = panel->getTextMaterialNode(generator, *style.textMaterial);
 
             // TODO: If math::float3 were directly constructible from
             // std::array<std::convertible_to<float> T, 2> and std::convertible_to<float>,
             // this could be a lot prettier:
 
-            auto& widgetTansformNode = generator.createWidgetTransformNode(
-              widgetMtlNode,
-              math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer()));
-            widgetTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.box));
-            nodes.highlight =
-              &widgetTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.highlight));
-            nodes.checkmark =
-              &widgetTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.checkmark));
-
-            auto& labelTransformNode = generator.createWidgetTransformNode(
+            if (widgetMtlNode)
+            {
+                nodes.widgetTransform = &generator.createWidgetTransformNode(
+                  *widgetMtlNode,
+                  math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer()));
+                if (!staticBatches)
+                    nodes.box =
+                      &nodes.widgetTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.box));
+                nodes.highlight =
+                  &nodes.widgetTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.highlight));
+                nodes.checkmark =
+                  &nodes.widgetTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.checkmark));
+            }
+
+            nodes.labelTransform = &generator.createWidgetTransformNode(
               textMtlNode, math::float3(blocks.label->bounds.x0, blocks.label->bounds.y0, getInputLayer()));
-            labelTransformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.label));
+            nodes.label =
+              &nodes.labelTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.label));
+
+            // Transform nodes are children of the shared material nodes and need to be detached explicitly.
+            if (nodes.widgetTransform) ownNode(nodes.widgetTransform->getAsNode());
+            ownNode(nodes.labelTransform->getAsNode());
         }
         else
         {
-            // TODO: Update nodes if they already exist.
+            // Geometry may have been regenerated since the nodes were created.
+            if (nodes.widgetTransform)
+            {
+                if (nodes.box) nodes.box->setMesh(meshes.box);
+                nodes.highlight->setMesh(meshes.highlight);
+                nodes.checkmark->setMesh(meshes.checkmark);
+            }
+            nodes.label->setMesh(meshes.label);
+
+            // Layout was moved. Meshes are local to the transform nodes, so only the offsets need to be updated.
+            if (any(staleData & StaleData::Transform))
+            {
+                if (nodes.widgetTransform)
+                    nodes.widgetTransform->setOffset(
+                      math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer()));
+                nodes.labelTransform->setOffset(
+                  math::float3(blocks.label->bounds.x0, blocks.label->bounds.y0, getInputLayer()));
+            }
         }
 
-        // Set visibility of highlight.
-        if (state.entered)
-            nodes.highlight->setTypeMask(0);
-        else
-            nodes.highlight->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+        const bool checked = dataSource && dataSource->get();
 
-        // Set visibility of checkmark.
-        if (dataSource && dataSource->get())
-            nodes.checkmark->setTypeMask(0);
+        if (instanceBatches)
+        {
+            // Instances are moved to another batch if their mesh or material changed.
+            const auto type   = std::type_index(typeid(*this));
+            const auto offset =
+              math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer());
+            const auto flags  = [](const bool visible) {
+                return visible ? InstanceData::Flags::None : InstanceData::Flags::Hidden;
+            };
+            instanceBatches->replace(instances.box, type, *meshes.box, style.widgetMaterial, {offset, flags(true)});
+            instanceBatches->replace(
+              instances.highlight, type, *meshes.highlight, style.widgetMaterial, {offset, flags(state.entered)});
+            instanceBatches->replace(
+              instances.checkmark, type, *meshes.checkmark, style.widgetMaterial, {offset, flags(checked)});
+        }
         else
-            nodes.checkmark->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+        {
+            // Sub-range is moved to another batch if the material or layer changed.
+            if (staticBatches)
+                staticBatches->replace(batchedBox,
+                                       style.widgetMaterial,
+                                       getInputLayer(),
+                                       {.shape  = getBoxShape(),
+                                        .offset = math::float3(blocks.box->bounds.center()[0],
+                                                               blocks.box->bounds.center()[1],
+                                                               getInputLayer())});
+
+            // Set visibility of highlight.
+            if (state.entered)
+                nodes.highlight->setTypeMask(0);
+            else
+                nodes.highlight->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+
+            // Set visibility of checkmark.
+            if (checked)
+                nodes.checkmark->setTypeMask(0);
+            else
+                nodes.checkmark->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
+        }
 
-        staleData = staleData & ~StaleData::Scenegraph;
+        staleData = staleData & ~(StaleData::Scenegraph | StaleData::Transform);
     }
 
     ////////////////////////////////////////////////////////////////
@@ -210,14 +293,14 @@ namespace floah
     InputContext::MouseEnterResult Checkbox::onMouseEnter(const InputContext::MouseEnterEvent&)
     {
         state.entered = true;
-        staleData |= StaleData::Scenegraph;
+        markStale(StaleData::Scenegraph);
         return {};
     }
 
     InputContext::MouseExitResult Checkbox::onMouseExit(const InputContext::MouseExitEvent&)
     {
         state.entered = false;
-        staleData |= StaleData::Scenegraph;
+        markStale(StaleData::Scenegraph);
         return {};
     }
 
@@ -235,12 +318,75 @@ namespace floah
     // DataListener.
     ////////////////////////////////////////////////////////////////
 
-    void Checkbox::onDataSourceUpdate(DataSource&) { staleData |= StaleData::Scenegraph; }
+    void Checkbox::onDataSourceUpdate(DataSource&) { markStale(StaleData::Scenegraph); }
+
+    ////////////////////////////////////////////////////////////////
+    // Geometry.
+    ////////////////////////////////////////////////////////////////
+
+    RectangleShape Checkbox::getBoxShape() const
+    {
+        const auto size = static_cast<float>(math::min(blocks.box->bounds.width(), blocks.box->bounds.height()));
+        return {.lower    = -0.5f * math::float2(size),
+                .upper    = 0.5f * math::float2(size),
+                .fillMode = RectangleGenerator::FillMode::Outline,
+                .margin   = Length(2),
+                .color    = style.color};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scenegraph.
+    ////////////////////////////////////////////////////////////////
+
+    void Checkbox::releaseNodes()
+    {
+        if (nodes.box) nodes.box->setMesh(nullptr);
+        if (nodes.highlight) nodes.highlight->setMesh(nullptr);
+        if (nodes.checkmark) nodes.checkmark->setMesh(nullptr);
+        nodes.label->setMesh(nullptr);
+        poolNodes(nodes);
+        nodes = {};
+    }
 
     ////////////////////////////////////////////////////////////////
     // Stylesheet getters.
     ////////////////////////////////////////////////////////////////
 
+    Widget::StaleData Checkbox::getStyleDependency(const StyleKey key) const noexcept
+    {
+        // Properties that affect the layout invalidate everything that follows from it.
+        constexpr StyleKey layoutKeys[] = {checkbox_box_height,
+                                           checkbox_box_margin,
+                                           checkbox_box_size,
+                                           checkbox_box_width,
+                                           checkbox_label_height,
+                                           checkbox_label_margin,
+                                           checkbox_label_size,
+                                           checkbox_label_width};
+        if (std::ranges::find(layoutKeys, key) != std::ranges::end(layoutKeys)) return StaleData::All;
+
+        if (key == "color") return StaleData::Geometry | StaleData::Scenegraph;
+
+        if (key == checkbox_material_text || key == checkbox_material_widget || key == material_text ||
+            key == material_widget)
+            return StaleData::Scenegraph;
+
+        return StaleData::None;
+    }
+
+    void Checkbox::resolveStyle()
+    {
+        style.boxHeight      = getBoxHeight();
+        style.boxMargin      = getBoxMargin();
+        style.boxWidth       = getBoxWidth();
+        style.labelHeight    = getLabelHeight();
+        style.labelMargin    = getLabelMargin();
+        style.labelWidth     = getLabelWidth();
+        style.textMaterial   = getTextMaterial();
+        style.widgetMaterial = getWidgetMaterial();
+        style.color          = getColor();
+    }
+
     Length Checkbox::getBoxHeight() const noexcept
     {
         const auto height = getStylesheetProperty<Length>(checkbox_box_height);
@@ -4,6 +4,7 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <ranges>
 
 ////////////////////////////////////////////////////////////////
@@ -38,23 +39,24 @@ namespace floah
 
     Dropdown::~Dropdown() noexcept
     {
-        if (meshes.box)
-        {
-            auto& meshManager = meshes.box->getMeshManager();
-            meshManager.destroyMesh(meshes.box->getUuid());
-            meshManager.destroyMesh(meshes.highlight->getUuid());
-            meshManager.destroyMesh(meshes.value->getUuid());
-            meshManager.destroyMesh(meshes.label->getUuid());
-            meshManager.destroyMesh(meshes.itemsBack->getUuid());
-            meshManager.destroyMesh(meshes.itemsHighlight->getUuid());
-            std::ranges::for_each(meshes.items,
-                                  [](auto* mesh) { mesh->getMeshManager().destroyMesh(mesh->getUuid()); });
-        }
+        // Nodes are pooled for reuse by a new dropdown. They must no longer refer to the meshes released below.
+        if (nodes.labelTransform) releaseNodes();
 
-        // TODO: Destroy nodes.
+        // Meshes are released after the nodes that refer to them were detached, when the panel is updated.
+        releaseMesh(meshes.box);
+        releaseMesh(meshes.highlight);
+        releaseMesh(meshes.itemsBack);
+        releaseMesh(meshes.itemsHighlight);
+        releaseTextMesh(meshes.value);
+        releaseTextMesh(meshes.label);
+        for (auto& slot : meshes.items) releaseTextMesh(slot.mesh);
+
+        if (auto* batches = getStaticBatches()) batches->remove(batchedBox);
 
         if (indexDataSource) indexDataSource->removeDataListener(*this);
         if (itemsDataSource) itemsDataSource->removeDataListener(*this);
+        if (auto* notifier = dynamic_cast<ListChangeNotifier*>(itemsDataSource))
+            notifier->removeListChangeListener(*this);
     }
 
     ////////////////////////////////////////////////////////////////
@@ -71,6 +73,8 @@ namespace floah
 
     IIntegralValueDataSource* Dropdown::getIndexDataSource() const noexcept { return indexDataSource; }
 
+    size_t Dropdown::getItemsPageSize() const noexcept { return itemsPageSize; }
+
     ////////////////////////////////////////////////////////////////
     // Setters.
     ////////////////////////////////////////////////////////////////
@@ -79,11 +83,19 @@ namespace floah
 
     void Dropdown::setItemsDataSource(IListDataSource* source)
     {
+        // Sources that can report which items changed are listened to for those changes as well.
+        auto* oldSource = itemsDataSource;
         if (replaceDataSource(&itemsDataSource, source))
         {
-            staleData |= StaleData::Geometry | StaleData::Scenegraph;
+            if (auto* notifier = dynamic_cast<ListChangeNotifier*>(oldSource))
+                notifier->removeListChangeListener(*this);
+            if (auto* notifier = dynamic_cast<ListChangeNotifier*>(itemsDataSource))
+                notifier->addListChangeListener(*this);
+
+            markStale(StaleData::Geometry | StaleData::Scenegraph);
             state.isValueMeshState = true;
             state.isItemsMeshStale = true;
+            resetItemsLoader();
         }
     }
 
@@ -91,17 +103,28 @@ namespace floah
     {
         if (replaceDataSource(&indexDataSource, source))
         {
-            staleData |= StaleData::Geometry | StaleData::Scenegraph;
+            markStale(StaleData::Geometry | StaleData::Scenegraph);
             state.isValueMeshState = true;
             state.isItemsMeshStale = true;
         }
     }
 
+    void Dropdown::setItemsPageSize(const size_t size)
+    {
+        if (itemsPageSize == size) return;
+
+        itemsPageSize = size;
+        markStale(StaleData::Geometry | StaleData::Scenegraph);
+        state.isValueMeshState = true;
+        state.isItemsMeshStale = true;
+        resetItemsLoader();
+    }
+
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
-    void Dropdown::generateLayout(Size size, Size offset)
+    void Dropdown::prepareLayout()
     {
         // Create layout elements if they do not exist.
         if (!elements.root)
@@ -111,7 +134,17 @@ namespace floah
             elements.box    = &elements.active->append(std::make_unique<LayoutElement>());
             elements.label  = &elements.active->append(std::make_unique<LayoutElement>());
             elements.items  = &elements.root->append(std::make_unique<LayoutElement>());
+
+            bindLayoutBlock(*elements.box, blocks.box);
+            bindLayoutBlock(*elements.label, blocks.label);
+            bindLayoutBlock(*elements.items, blocks.items);
         }
+    }
+
+    void Dropdown::generateLayout(Size size, Size offset)
+    {
+        prepareLayout();
+        updateStyle();
 
         // Style layout elements.
         elements.root->getSize().setWidth(Length(1.0f));
@@ -119,116 +152,113 @@ namespace floah
         elements.active->getSize().setWidth(Length(1.0f));
         elements.active->getSize().setHeight(Length(1.0f));
 
-        elements.box->getSize().setWidth(getBoxWidth());
-        elements.box->getSize().setHeight(getBoxHeight());
-        elements.box->getOuterMargin() = getBoxMargin();
+        elements.box->getSize().setWidth(style.boxWidth);
+        elements.box->getSize().setHeight(style.boxHeight);
+        elements.box->getOuterMargin() = style.boxMargin;
 
-        elements.label->getSize().setWidth(getLabelWidth());
-        elements.label->getSize().setHeight(getLabelHeight());
-        elements.label->getOuterMargin() = getLabelMargin();
+        elements.label->getSize().setWidth(style.labelWidth);
+        elements.label->getSize().setHeight(style.labelHeight);
+        elements.label->getOuterMargin() = style.labelMargin;
 
-        elements.items->getSize().setWidth(getBoxWidth());
-        elements.items->getSize().setHeight(getItemsHeight() * getItemsMax());
+        elements.items->getSize().setWidth(style.boxWidth);
+        elements.items->getSize().setHeight(style.itemsHeight * style.itemsMax);
 
         Widget::generateLayout(size, offset);
-
-        // Get blocks for relevant elements.
-        auto it =
-          std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == elements.box->getId(); });
-        blocks.box = &*it;
-        it = std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == elements.label->getId(); });
-        blocks.label = &*it;
-        it = std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == elements.items->getId(); });
-        blocks.items = &*it;
     }
 
     void Dropdown::generateGeometry(sol::MeshManager& meshManager, FontMap& fontMap)
     {
         if (!blocks.box) throw FloahError("Cannot generate geometry. Layout was not generated yet.");
+        updateStyle();
 
         Generator::Params params{.meshManager = meshManager, .fontMap = fontMap};
 
-        if (!meshes.box)
+        // Shapes and texts are shared with identical widgets.
+        auto& cache     = *getMeshCache();
+        auto& textCache = *getTextMeshCache();
+
+        // Boxes that are batched are merged into the static batches instead.
+        if (!meshes.box && !getStaticBatches()) cache.replace(meshes.box, getBoxShape(), params);
+
+        if (!meshes.highlight)
         {
-            RectangleGenerator gen;
-            gen.lower    = -0.5f * math::float2(blocks.box->bounds.width(), blocks.box->bounds.height());
-            gen.upper    = -gen.lower;
-            gen.fillMode = RectangleGenerator::FillMode::Outline;
-            gen.margin   = Length(2);
-            gen.color    = getColor();
-            meshes.box   = &gen.generate(params);
+            auto highlight     = getBoxShape();
+            highlight.fillMode = RectangleGenerator::FillMode::Fill;
+            cache.replace(meshes.highlight, highlight, params);
         }
 
-        if (!meshes.highlight)
+        // Request the pages of the value and visible items before fetching, so that they are loaded in parallel.
+        if (itemsLoader)
         {
-            RectangleGenerator gen;
-            gen.lower        = -0.5f * math::float2(blocks.box->bounds.width(), blocks.box->bounds.height());
-            gen.upper        = -gen.lower;
-            gen.fillMode     = RectangleGenerator::FillMode::Fill;
-            gen.margin       = Length(2);
-            gen.color        = getColor();
-            meshes.highlight = &gen.generate(params);
+            itemsLoader->request(indexDataSource->get<size_t>(), 1);
+            if (state.opened) itemsLoader->request(static_cast<size_t>(state.scroll), getVisibleItemCount());
         }
 
         if (!meshes.value || state.isValueMeshState)
         {
-            state.isValueMeshState = false;
-
-            // Destroy old mesh.
-            if (meshes.value) meshes.value->getMeshManager().destroyMesh(meshes.value->getUuid());
-
             TextGenerator gen;
-            gen.text     = itemsDataSource->getString(indexDataSource->get<size_t>());
-            meshes.value = &gen.generate(params);
+            state.isValuePlaceholder = !fetchItem(indexDataSource->get<size_t>(), gen.text);
+            state.isValueMeshState   = false;
+            textCache.replace(meshes.value, gen, params);
         }
 
         if (!meshes.label)
         {
             TextGenerator gen;
-            gen.text     = label;
-            meshes.label = &gen.generate(params);
+            gen.text = label;
+            textCache.replace(meshes.label, gen, params);
         }
 
-        if (state.opened && (meshes.items.empty() || state.isItemsMeshStale))
+        if (state.opened)
         {
-            state.isItemsMeshStale = false;
-
-            // Destroy old meshes.
-            std::ranges::for_each(meshes.items,
-                                  [](auto* mesh) { mesh->getMeshManager().destroyMesh(mesh->getUuid()); });
-
-            meshes.items.resize(math::min(itemsDataSource->getSize(), getItemsMax()));
+            // Invalidate all slots, but keep their meshes until they are replaced so that unchanged text is reused.
+            if (state.isItemsMeshStale || meshes.items.size() != style.itemsMax)
+            {
+                for (size_t i = style.itemsMax; i < meshes.items.size(); i++) textCache.release(meshes.items[i].mesh);
+                meshes.items.resize(style.itemsMax);
+                for (auto& slot : meshes.items) slot.index = ItemSlot::invalid_index;
+                state.isItemsMeshStale = false;
+            }
 
+            // Only regenerate items that entered the viewport or whose page arrived, replacing the item that left
+            // their slot.
             TextGenerator gen;
-            for (size_t i = 0; i < meshes.items.size(); i++)
+            for (size_t row = 0; row < getVisibleItemCount(); row++)
             {
-                gen.text        = itemsDataSource->getString(i + state.scroll);
-                meshes.items[i] = &gen.generate(params);
+                const auto index = static_cast<size_t>(state.scroll) + row;
+                auto&      slot  = meshes.items[index % meshes.items.size()];
+                if (slot.index == index && !(slot.placeholder && itemsLoader && itemsLoader->find(index))) continue;
+
+                slot.placeholder = !fetchItem(index, gen.text);
+                slot.index       = index;
+                textCache.replace(slot.mesh, gen, params);
             }
         }
 
         if (!meshes.itemsBack)
         {
-            RectangleGenerator gen;
-            gen.lower        = -0.5f * math::float2(blocks.items->bounds.width(), blocks.items->bounds.height());
-            gen.upper        = -gen.lower;
-            gen.fillMode     = RectangleGenerator::FillMode::Fill;
-            gen.margin       = Length(2);
-            gen.color        = math::float4(0.5f, 0.5f, 0.5f, 1.0f);  //getColor();
-            meshes.itemsBack = &gen.generate(params);
+            const auto size = math::float2(blocks.items->bounds.width(), blocks.items->bounds.height());
+            cache.replace(meshes.itemsBack,
+                          RectangleShape{.lower    = -0.5f * size,
+                                         .upper    = 0.5f * size,
+                                         .fillMode = RectangleGenerator::FillMode::Fill,
+                                         .margin   = Length(2),
+                                         .color    = math::float4(0.5f, 0.5f, 0.5f, 1.0f)},  //getColor();
+                          params);
         }
 
         if (!meshes.itemsHighlight)
         {
-            RectangleGenerator gen;
-            gen.lower = math::float2(0);
-            gen.upper =
+            const auto upper =
               math::float2(static_cast<float>(blocks.items->bounds.width()),
-                           static_cast<float>(blocks.items->bounds.height()) / static_cast<float>(getItemsMax()));
-            gen.fillMode          = RectangleGenerator::FillMode::Outline;
-            gen.margin            = Length(2);
-            gen.color             = getColor();
-            meshes.itemsHighlight = &gen.generate(params);
+                           static_cast<float>(blocks.items->bounds.height()) / static_cast<float>(style.itemsMax));
+            cache.replace(meshes.itemsHighlight,
+                          RectangleShape{.lower    = math::float2(0),
+                                         .upper    = upper,
+                                         .fillMode = RectangleGenerator::FillMode::Outline,
+                                         .margin   = Length(2),
+                                         .color    = style.color},
+                          params);
         }
 
         staleData = staleData & ~StaleData::Geometry;
@@ -236,78 +266,165 @@ namespace floah
 
     void Dropdown::generateScenegraph(IScenegraphGenerator& generator)
     {
-        if (!meshes.box) throw FloahError("Cannot generate scenegraph. Geometry was not generated yet.");
+        if (!meshes.highlight) throw FloahError("Cannot generate scenegraph. Geometry was not generated yet.");
+        updateStyle();
+
+        // If batching is enabled, the static box is drawn from the static batches of the panel.
+        auto* staticBatches = getStaticBatches();
+
+        // Nodes are attached to the material nodes of the materials they were created with. If the style changed the
+        // materials since, the nodes are pooled and replaced.
+        if (nodes.labelTransform && nodeMaterialsChanged(style.widgetMaterial, style.textMaterial)) releaseNodes();
 
-        if (!nodes.root)
+        // Adopt the nodes of a destroyed dropdown. They are pointed at the meshes of this one and moved below.
+        if (!nodes.labelTransform)
+        {
+            auto pooled = adoptNodes(typeid(Dropdown), style.widgetMaterial, style.textMaterial);
+            if (pooled.has_value())
+            {
+                nodes = std::any_cast<decltype(nodes)>(std::move(pooled));
+                staleData |= StaleData::Transform;
+
+                // The previous dropdown may have shown a different number of items. Surplus item nodes are kept, but
+                // never get a mesh, because there are no rows for them.
+                while (nodes.items.size() < style.itemsMax)
+                {
+                    auto& item     = nodes.items.emplace_back();
+                    item.transform = &generator.createWidgetTransformNode(*nodes.textItems, math::float3(0));
+                    item.node      = &item.transform->getAsNode().addChild(std::make_unique<sol::MeshNode>());
+                }
+            }
+        }
+
+        if (!nodes.labelTransform)
         {
             // TODO: If math::float3 were directly constructible from
             // std::array<std::convertible_to<float> T, 2> and std::convertible_to<float>,
             // this could be a lot prettier:
-            nodes.root = &generator.createWidgetNode(panel->getPanelNode());
-
-            auto& widgetMtlNode = nodes.root->addChild(std::make_unique<sol::ForwardMaterialNode>());
-            widgetMtlNode.setMaterial(getWidgetMaterial());
 
-            auto& textMtlNode = generator.createTextMaterialNode(*nodes.root, *getTextMaterial());
+            // Material nodes are shared with the other widgets in the panel.
+            auto& widgetMtlNode = panel->getWidgetMaterialNode(generator, style.widgetMaterial);
+            auto& textMtlNode   = panel->getTextMaterialNode(generator, *style.textMaterial);
 
-            auto& widgetTansformNode = generator.createWidgetTransformNode(
+            nodes.widgetTransform = &generator.createWidgetTransformNode(
               widgetMtlNode,
               math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer()));
-            widgetTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.box));
+            if (!staticBatches)
+                nodes.box =
+                  &nodes.widgetTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.box));
             nodes.highlight =
-              &widgetTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.highlight));
+              &nodes.widgetTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.highlight));
 
-            auto& valueTransformNode = generator.createWidgetTransformNode(
+            nodes.valueTransform = &generator.createWidgetTransformNode(
               textMtlNode, math::float3(blocks.box->bounds.x0, blocks.box->bounds.y0, getInputLayer()));
-            nodes.value = &valueTransformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.value));
+            nodes.value =
+              &nodes.valueTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.value));
 
-            auto& labelTransformNode = generator.createWidgetTransformNode(
+            nodes.labelTransform = &generator.createWidgetTransformNode(
               textMtlNode, math::float3(blocks.label->bounds.x0, blocks.label->bounds.y0, getInputLayer()));
-            labelTransformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.label));
-
-            nodes.widgetItems = &widgetMtlNode.addChild(std::make_unique<sol::Node>());
-            auto& backTansformNode =
-              generator.createWidgetTransformNode(*nodes.widgetItems,
-                                                  math::float3(static_cast<float>(blocks.items->bounds.center()[0]),
-                                                               static_cast<float>(blocks.items->bounds.center()[1]),
-                                                               static_cast<float>(getInputLayer()) - 0.2f));
-            backTansformNode.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.itemsBack));
+            nodes.label =
+              &nodes.labelTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.label));
+
+            nodes.widgetItems        = &widgetMtlNode.addChild(std::make_unique<sol::Node>());
+            nodes.itemsBackTransform = &generator.createWidgetTransformNode(
+              *nodes.widgetItems,
+              math::float3(static_cast<float>(blocks.items->bounds.center()[0]),
+                           static_cast<float>(blocks.items->bounds.center()[1]),
+                           static_cast<float>(getInputLayer()) - 0.2f));
+            nodes.itemsBack =
+              &nodes.itemsBackTransform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.itemsBack));
 
             nodes.itemsHighlightTransform = &generator.createWidgetTransformNode(*nodes.widgetItems, math::float3(0));
-            nodes.itemsHighlightTransform->getAsNode().addChild(
+            nodes.itemsHighlight = &nodes.itemsHighlightTransform->getAsNode().addChild(
               std::make_unique<sol::MeshNode>(*meshes.itemsHighlight));
 
             nodes.textItems = &textMtlNode.addChild(std::make_unique<sol::Node>());
-            const auto h    = static_cast<float>(blocks.items->bounds.height()) / static_cast<float>(getItemsMax());
-            for (size_t i = 0; i < getItemsMax(); i++)
+            const auto h    = static_cast<float>(blocks.items->bounds.height()) / static_cast<float>(style.itemsMax);
+            const auto z    = static_cast<float>(getInputLayer() + 1);
+            nodes.items.resize(style.itemsMax);
+            for (size_t i = 0; i < style.itemsMax; i++)
             {
-                auto& trans = generator.createWidgetTransformNode(
+                auto& item     = nodes.items[i];
+                item.transform = &generator.createWidgetTransformNode(
                   *nodes.textItems,
                   math::float3(static_cast<float>(blocks.items->bounds.x0),
                                static_cast<float>(blocks.items->bounds.y0) + static_cast<float>(i) * h,
-                               static_cast<float>(getInputLayer() + 1)));
+                               z));
+                item.mesh = getItemMesh(i);
+                item.z    = z;
 
-                if (i < meshes.items.size())
-                    trans.getAsNode().addChild(std::make_unique<sol::MeshNode>(*meshes.items[i]));
+                if (item.mesh)
+                    item.node = &item.transform->getAsNode().addChild(std::make_unique<sol::MeshNode>(*item.mesh));
                 else
-                    trans.getAsNode().addChild(std::make_unique<sol::MeshNode>());
+                    item.node = &item.transform->getAsNode().addChild(std::make_unique<sol::MeshNode>());
             }
+
+            // These nodes are children of the shared material nodes and need to be detached explicitly.
+            ownNode(nodes.widgetTransform->getAsNode());
+            ownNode(nodes.valueTransform->getAsNode());
+            ownNode(nodes.labelTransform->getAsNode());
+            ownNode(*nodes.widgetItems);
+            ownNode(*nodes.textItems);
         }
         else
         {
+            // Geometry may have been regenerated since the nodes were created.
+            if (nodes.box) nodes.box->setMesh(meshes.box);
+            nodes.highlight->setMesh(meshes.highlight);
             nodes.value->setMesh(meshes.value);
+            nodes.label->setMesh(meshes.label);
+            nodes.itemsBack->setMesh(meshes.itemsBack);
+            nodes.itemsHighlight->setMesh(meshes.itemsHighlight);
 
-            size_t i = 0;
-            for (auto& child : nodes.textItems->getChildren())
+            // Layout was moved. Meshes are local to the transform nodes, so only the offsets need to be updated.
+            const bool moved = any(staleData & StaleData::Transform);
+            if (moved)
             {
-                auto& transformNode = dynamic_cast<ITransformNode&>(*child);
-                auto& meshNode      = dynamic_cast<sol::MeshNode&>(*transformNode.getAsNode().getChildren()[0]);
-                transformNode.setZ(static_cast<float>(getInputLayer() + 1));
-                meshNode.setMesh(i < meshes.items.size() ? meshes.items[i] : nullptr);
-                i++;
+                nodes.widgetTransform->setOffset(
+                  math::float3(blocks.box->bounds.center()[0], blocks.box->bounds.center()[1], getInputLayer()));
+                nodes.valueTransform->setOffset(
+                  math::float3(blocks.box->bounds.x0, blocks.box->bounds.y0, getInputLayer()));
+                nodes.labelTransform->setOffset(
+                  math::float3(blocks.label->bounds.x0, blocks.label->bounds.y0, getInputLayer()));
+                nodes.itemsBackTransform->setOffset(
+                  math::float3(static_cast<float>(blocks.items->bounds.center()[0]),
+                               static_cast<float>(blocks.items->bounds.center()[1]),
+                               static_cast<float>(getInputLayer()) - 0.2f));
+            }
+
+            // Only touch item nodes whose offset or mesh changed. Hovering over the items does neither.
+            const auto h = static_cast<float>(blocks.items->bounds.height()) / static_cast<float>(style.itemsMax);
+            const auto z = static_cast<float>(getInputLayer() + 1);
+            for (size_t i = 0; i < nodes.items.size(); i++)
+            {
+                auto& item = nodes.items[i];
+                if (moved)
+                    item.transform->setOffset(
+                      math::float3(static_cast<float>(blocks.items->bounds.x0),
+                                   static_cast<float>(blocks.items->bounds.y0) + static_cast<float>(i) * h,
+                                   z));
+                else if (item.z != z)
+                    item.transform->setZ(z);
+                item.z = z;
+
+                if (auto* mesh = getItemMesh(i); mesh != item.mesh)
+                {
+                    item.node->setMesh(mesh);
+                    item.mesh = mesh;
+                }
             }
         }
 
+        // Sub-range is moved to another batch if the material or layer changed.
+        if (staticBatches)
+            staticBatches->replace(batchedBox,
+                                   style.widgetMaterial,
+                                   getInputLayer(),
+                                   {.shape  = getBoxShape(),
+                                    .offset = math::float3(blocks.box->bounds.center()[0],
+                                                           blocks.box->bounds.center()[1],
+                                                           getInputLayer())});
+
         // Set visibility of highlight.
         if (state.entered && !state.opened)
             nodes.highlight->setTypeMask(0);
@@ -329,7 +446,7 @@ namespace floah
 
                 const float offset = static_cast<float>(state.hightlight) *
                                      static_cast<float>(blocks.items->bounds.height()) /
-                                     static_cast<float>(getItemsMax());
+                                     static_cast<float>(style.itemsMax);
                 nodes.itemsHighlightTransform->setOffset(
                   math::float3(static_cast<float>(blocks.items->bounds.x0),
                                static_cast<float>(blocks.items->bounds.y0) + offset,
@@ -342,7 +459,29 @@ namespace floah
             nodes.widgetItems->setTypeMask(static_cast<uint64_t>(NodeMasks::Disabled));
         }
 
-        staleData = staleData & ~StaleData::Scenegraph;
+        staleData = staleData & ~(StaleData::Scenegraph | StaleData::Transform);
+    }
+
+    void Dropdown::poll()
+    {
+        if (!itemsLoader || !itemsLoader->poll() || !indexDataSource) return;
+
+        // Only regenerate if the value or a visible row was waiting for one of the pages that arrived.
+        bool stale = false;
+        if (state.isValuePlaceholder && itemsLoader->find(indexDataSource->get<size_t>()))
+        {
+            state.isValueMeshState = true;
+            stale                  = true;
+        }
+
+        for (size_t row = 0; state.opened && !stale && !meshes.items.empty() && row < getVisibleItemCount(); row++)
+        {
+            const auto  index = static_cast<size_t>(state.scroll) + row;
+            const auto& slot  = meshes.items[index % meshes.items.size()];
+            stale             = slot.index == index && slot.placeholder && itemsLoader->find(index);
+        }
+
+        if (stale) markStale(StaleData::Geometry | StaleData::Scenegraph);
     }
 
     ////////////////////////////////////////////////////////////////
@@ -370,14 +509,14 @@ namespace floah
     InputContext::MouseEnterResult Dropdown::onMouseEnter(const InputContext::MouseEnterEvent&)
     {
         state.entered = true;
-        staleData |= StaleData::Scenegraph;
+        markStale(StaleData::Scenegraph);
         return {};
     }
 
     InputContext::MouseExitResult Dropdown::onMouseExit(const InputContext::MouseExitEvent&)
     {
         state.entered = false;
-        staleData |= StaleData::Scenegraph;
+        markStale(StaleData::Scenegraph);
         return {};
     }
 
@@ -388,7 +527,7 @@ namespace floah
             if (state.opened)
             {
                 state.opened = false;
-                staleData |= StaleData::Scenegraph;
+                markStale(StaleData::Scenegraph);
 
                 // Update index (if at all possible).
                 if (!indexDataSource || !itemsDataSource || state.hightlight == -1) return {.claim = false};
@@ -398,7 +537,7 @@ namespace floah
             }
 
             state.opened = true;
-            staleData |= StaleData::Geometry | StaleData::Scenegraph;
+            markStale(StaleData::Geometry | StaleData::Scenegraph);
             return {.claim = true};
         }
 
@@ -407,7 +546,8 @@ namespace floah
 
     InputContext::MouseMoveResult Dropdown::onMouseMove(const InputContext::MouseMoveEvent& move)
     {
-        staleData |= StaleData::Scenegraph;
+        updateStyle();
+        markStale(StaleData::Scenegraph);
 
         if (state.opened)
         {
@@ -421,7 +561,7 @@ namespace floah
             {
                 const float y = static_cast<float>(move.current.y - blocks.items->bounds.y0) /
                                 static_cast<float>(blocks.items->bounds.height());
-                state.hightlight = static_cast<int32_t>(y * static_cast<float>(getItemsMax()));
+                state.hightlight = static_cast<int32_t>(y * static_cast<float>(style.itemsMax));
 
                 // TODO: Include scroll offset.
                 // Limit to visible items.
@@ -442,11 +582,8 @@ namespace floah
         state.scroll -= scroll.scroll.y;
         calculateScroll();
 
-        if (state.scroll != oldScroll)
-        {
-            staleData |= StaleData::Geometry | StaleData::Scenegraph;
-            state.isItemsMeshStale = true;
-        }
+        // Items that stay visible keep their slot. Only the rows that entered the viewport are generated.
+        if (state.scroll != oldScroll) markStale(StaleData::Geometry | StaleData::Scenegraph);
 
         return {};
     }
@@ -455,17 +592,188 @@ namespace floah
     // DataListener.
     ////////////////////////////////////////////////////////////////
 
-    void Dropdown::onDataSourceUpdate(DataSource&)
+    void Dropdown::onDataSourceUpdate(DataSource& source)
     {
-        staleData |= StaleData::Geometry | StaleData::Scenegraph;
+        markStale(StaleData::Geometry | StaleData::Scenegraph);
         state.isValueMeshState = true;
+
+        // A different index only changes the value.
+        if (&source == indexDataSource) return;
+
         state.isItemsMeshStale = true;
+        if (itemsLoader && &source == itemsDataSource) itemsLoader->invalidate();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // ListChangeListener.
+    ////////////////////////////////////////////////////////////////
+
+    void Dropdown::onListDataSourceUpdate(IListDataSource& source, const ListChange& change)
+    {
+        if (&source != itemsDataSource || change.count == 0) return;
+
+        // Fetched pages no longer match the indices. Rows that still show a placeholder are fetched again.
+        if (itemsLoader) itemsLoader->invalidate();
+
+        const auto first = change.first;
+        const auto last  = change.first + change.count;
+
+        // New index of an item held by a slot. Items that were removed or modified lose their slot.
+        const auto remap = [&](const size_t index) {
+            if (index == ItemSlot::invalid_index || index < first) return index;
+            switch (change.type)
+            {
+            case ListChange::Type::Insert: return index + change.count;
+            case ListChange::Type::Remove: return index < last ? ItemSlot::invalid_index : index - change.count;
+            case ListChange::Type::Update: return index < last ? ItemSlot::invalid_index : index;
+            }
+            return ItemSlot::invalid_index;
+        };
+
+        // Hovered item keeps its highlight if it is still visible.
+        const auto oldScroll = static_cast<size_t>(state.scroll);
+        const auto hovered   = state.hightlight == -1 ? ItemSlot::invalid_index
+                                                      : remap(oldScroll + static_cast<size_t>(state.hightlight));
+
+        calculateScroll();
+
+        const auto scroll = static_cast<size_t>(state.scroll);
+        const auto n      = meshes.items.size();
+        bool       moved  = false;
+        if (state.hightlight != -1)
+        {
+            const auto oldHighlight = state.hightlight;
+            state.hightlight = hovered != ItemSlot::invalid_index && hovered >= scroll &&
+                                   hovered < scroll + getVisibleItemCount()
+                                 ? static_cast<int32_t>(hovered - scroll)
+                                 : -1;
+            moved = state.hightlight != oldHighlight;
+        }
+
+        // Selected item follows its index. If it was removed, the item that took its place is selected. Setting the
+        // index regenerates the value through onDataSourceUpdate.
+        if (indexDataSource)
+        {
+            const auto index    = indexDataSource->get<size_t>();
+            auto       selected = remap(index);
+            if (selected == ItemSlot::invalid_index)
+            {
+                state.isValueMeshState = true;
+                const auto size        = itemsDataSource->getSize();
+                selected = change.type == ListChange::Type::Update ? index : math::min(first, size > 0 ? size - 1 : 0);
+            }
+            if (selected != index) indexDataSource->set(selected);
+        }
+
+        // Move slots to the position of their new index. Slots that lost their item keep the mesh in a free position,
+        // so that it is replaced through the text mesh cache later on instead of being destroyed while in use.
+        std::vector<ItemSlot>    ring(n);
+        std::vector<sol::IMesh*> freeMeshes;
+        for (const auto& slot : meshes.items)
+        {
+            const auto index = remap(slot.index);
+            moved |= index != slot.index;
+            if (index != ItemSlot::invalid_index && index >= scroll && index < scroll + n)
+                ring[index % n] = {.index = index, .mesh = slot.mesh, .placeholder = slot.placeholder};
+            else if (slot.mesh)
+                freeMeshes.push_back(slot.mesh);
+        }
+        for (auto& slot : ring)
+        {
+            if (slot.mesh || freeMeshes.empty()) continue;
+            slot.mesh = freeMeshes.back();
+            freeMeshes.pop_back();
+        }
+        meshes.items = std::move(ring);
+
+        // Only regenerate if the value or a visible row lost its mesh.
+        bool stale = state.isValueMeshState;
+        for (size_t row = 0; state.opened && !stale && row < getVisibleItemCount(); row++) stale = !getItemMesh(row);
+
+        if (stale)
+            markStale(StaleData::Geometry | StaleData::Scenegraph);
+        else if (moved && state.opened)
+            markStale(StaleData::Scenegraph);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Geometry.
+    ////////////////////////////////////////////////////////////////
+
+    RectangleShape Dropdown::getBoxShape() const
+    {
+        const auto size = math::float2(blocks.box->bounds.width(), blocks.box->bounds.height());
+        return {.lower    = -0.5f * size,
+                .upper    = 0.5f * size,
+                .fillMode = RectangleGenerator::FillMode::Outline,
+                .margin   = Length(2),
+                .color    = style.color};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scenegraph.
+    ////////////////////////////////////////////////////////////////
+
+    void Dropdown::releaseNodes()
+    {
+        if (nodes.box) nodes.box->setMesh(nullptr);
+        nodes.highlight->setMesh(nullptr);
+        nodes.value->setMesh(nullptr);
+        nodes.label->setMesh(nullptr);
+        nodes.itemsBack->setMesh(nullptr);
+        nodes.itemsHighlight->setMesh(nullptr);
+        for (auto& item : nodes.items)
+        {
+            item.node->setMesh(nullptr);
+            item.mesh = nullptr;
+        }
+        poolNodes(nodes);
+        nodes = {};
     }
 
     ////////////////////////////////////////////////////////////////
     // Stylesheet getters.
     ////////////////////////////////////////////////////////////////
 
+    Widget::StaleData Dropdown::getStyleDependency(const StyleKey key) const noexcept
+    {
+        // Properties that affect the layout invalidate everything that follows from it.
+        constexpr StyleKey layoutKeys[] = {dropdown_box_height,
+                                           dropdown_box_margin,
+                                           dropdown_box_size,
+                                           dropdown_box_width,
+                                           dropdown_items_height,
+                                           dropdown_items_max,
+                                           dropdown_label_height,
+                                           dropdown_label_margin,
+                                           dropdown_label_size,
+                                           dropdown_label_width};
+        if (std::ranges::find(layoutKeys, key) != std::ranges::end(layoutKeys)) return StaleData::All;
+
+        if (key == "color") return StaleData::Geometry | StaleData::Scenegraph;
+
+        if (key == dropdown_material_text || key == dropdown_material_widget || key == material_text ||
+            key == material_widget)
+            return StaleData::Scenegraph;
+
+        return StaleData::None;
+    }
+
+    void Dropdown::resolveStyle()
+    {
+        style.boxHeight      = getBoxHeight();
+        style.boxMargin      = getBoxMargin();
+        style.boxWidth       = getBoxWidth();
+        style.itemsHeight    = getItemsHeight();
+        style.itemsMax       = getItemsMax();
+        style.labelHeight    = getLabelHeight();
+        style.labelMargin    = getLabelMargin();
+        style.labelWidth     = getLabelWidth();
+        style.textMaterial   = getTextMaterial();
+        style.widgetMaterial = getWidgetMaterial();
+        style.color          = getColor();
+    }
+
     Length Dropdown::getBoxHeight() const noexcept
     {
         const auto height = getStylesheetProperty<Length>(dropdown_box_height);
@@ -574,9 +882,52 @@ namespace floah
 
     void Dropdown::calculateScroll() noexcept
     {
-        const auto max = getItemsMax(), size = itemsDataSource ? itemsDataSource->getSize() : 0;
+        updateStyle();
+        const auto max = style.itemsMax, size = itemsDataSource ? itemsDataSource->getSize() : 0;
         if (size <= max) { state.scroll = 0; }
         else { state.scroll = math::clamp(state.scroll, 0, static_cast<int32_t>(size - max)); }
     }
 
+    size_t Dropdown::getVisibleItemCount() const noexcept
+    {
+        if (!itemsDataSource) return 0;
+        const auto size = itemsDataSource->getSize(), scroll = static_cast<size_t>(state.scroll);
+        return scroll < size ? math::min(size - scroll, style.itemsMax) : 0;
+    }
+
+    void Dropdown::resetItemsLoader()
+    {
+        itemsLoader.reset();
+        if (itemsDataSource && itemsPageSize > 0)
+            itemsLoader = std::make_unique<PagedListLoader>(*itemsDataSource, itemsPageSize);
+        setPolling(itemsLoader != nullptr);
+    }
+
+    bool Dropdown::fetchItem(const size_t index, std::string& text) const
+    {
+        if (!itemsLoader)
+        {
+            text = itemsDataSource->getString(index);
+            return true;
+        }
+
+        if (const auto* str = itemsLoader->find(index))
+        {
+            text = *str;
+            return true;
+        }
+
+        text = item_placeholder;
+        return false;
+    }
+
+    sol::IMesh* Dropdown::getItemMesh(const size_t row) const noexcept
+    {
+        if (meshes.items.empty() || row >= getVisibleItemCount()) return nullptr;
+
+        const auto  index = static_cast<size_t>(state.scroll) + row;
+        const auto& slot  = meshes.items[index % meshes.items.size()];
+        return slot.index == index ? slot.mesh : nullptr;
+    }
+
 }  // namespace floah
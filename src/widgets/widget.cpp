@@ -1,5 +1,11 @@
 #include "floah-widget/widgets/widget.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -22,7 +28,11 @@ namespace floah
 
     Widget::Widget() : layout(std::make_unique<Layout>()) {}
 
-    Widget::~Widget() noexcept = default;
+    Widget::~Widget() noexcept
+    {
+        if (panel)
+            for (auto* node : ownedNodes) panel->destructionQueue.enqueue(*node);
+    }
 
     void Widget::destroy() { panel->destroyWidget(*this); }
 
@@ -34,6 +44,8 @@ namespace floah
 
     const Panel& Widget::getPanel() const noexcept { return *panel; }
 
+    WidgetHandle Widget::getHandle() const noexcept { return handle; }
+
     Layer* Widget::getLayer() noexcept { return layer; }
 
     const Layer* Widget::getLayer() const noexcept { return layer; }
@@ -52,6 +64,12 @@ namespace floah
 
     const Stylesheet* Widget::getPanelStylesheet() const noexcept { return panel->getStylesheet(); }
 
+    Widget::StaleData Widget::getStyleDependency(const StyleKey key) const noexcept
+    {
+        if (key == material_text || key == material_widget) return StaleData::Scenegraph;
+        return StaleData::All;
+    }
+
     Widget::StaleData Widget::getStaleData() const noexcept { return staleData; }
 
     ////////////////////////////////////////////////////////////////
@@ -63,24 +81,204 @@ namespace floah
         if (element.getLayout() != &panel->getLayout())
             throw FloahError("Cannot attach widget to element. It is not from the panel layout.");
 
+        if (panelElement == &element) return;
         panelElement = &element;
+        markStale(StaleData::All);
     }
 
-    void Widget::setStylesheet(Stylesheet* sheet) noexcept { stylesheet = sheet; }
+    void Widget::setStylesheet(Stylesheet* sheet)
+    {
+        if (stylesheet == sheet) return;
+        stylesheet = sheet;
+        invalidateStyle();
+    }
+
+    void Widget::invalidateStyle()
+    {
+        // Either stylesheet may have been modified in place, so drop the cached properties of both.
+        if (panel)
+        {
+            const Stylesheet* sheets[] = {stylesheet, getPanelStylesheet()};
+            panel->styleCache.invalidate(sheets);
+        }
+
+        markStyleStale();
+    }
+
+    void Widget::markStyleStale()
+    {
+        styleStale = true;
+        markStale(StaleData::All);
+    }
 
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
+    void Widget::prepareLayout() {}
+
     void Widget::generateLayout(const Size size, const Size offset)
     {
         layout->getSize()   = size;
         layout->getOffset() = offset;
-        layoutBlocks        = layout->generate();
 
-        staleData           = staleData & ~StaleData::Layout;
+        // Overwrite blocks in place if possible, so that pointers to them remain valid.
+        auto generated = layout->generate();
+        if (generated.size() == layoutBlocks.size())
+            std::ranges::move(generated, layoutBlocks.begin());
+        else
+            layoutBlocks = std::move(generated);
+
+        // The widget layout tree rarely changes, so blocks are usually still at the same index. Fall back to a search
+        // otherwise.
+        for (auto& binding : layoutBlockBindings)
+        {
+            const auto id = binding.element->getId();
+            if (binding.index >= layoutBlocks.size() || layoutBlocks[binding.index].id != id)
+            {
+                const auto it = std::ranges::find_if(layoutBlocks, [&](const auto& block) { return block.id == id; });
+                binding.index = static_cast<size_t>(std::ranges::distance(layoutBlocks.begin(), it));
+            }
+
+            *binding.block = binding.index < layoutBlocks.size() ? &layoutBlocks[binding.index] : nullptr;
+        }
+
+        staleData = staleData & ~StaleData::Layout;
+    }
+
+    void Widget::translateLayout(const math::int2 delta)
+    {
+        auto& offset = layout->getOffset();
+        // Offsets of widget layouts are absolute. Length(float) would make them relative.
+        offset.setWidth(Length(static_cast<int32_t>(offset.getWidth().get()) + delta.x));
+        offset.setHeight(Length(static_cast<int32_t>(offset.getHeight().get()) + delta.y));
+
+        for (auto& block : layoutBlocks)
+        {
+            block.bounds.x0 += delta.x;
+            block.bounds.y0 += delta.y;
+            block.bounds.x1 += delta.x;
+            block.bounds.y1 += delta.y;
+        }
+
+        markStale(StaleData::Transform | StaleData::Scenegraph);
+    }
+
+
+    void Widget::poll() {}
+
+    ////////////////////////////////////////////////////////////////
+    // Stale data.
+    ////////////////////////////////////////////////////////////////
+
+    void Widget::markStale(const StaleData data)
+    {
+        staleData |= data;
+        if (panel) panel->enqueueStaleWidget(*this);
+    }
+
+    void Widget::setPolling(const bool enabled)
+    {
+        if (polling == enabled) return;
+        polling = enabled;
+
+        // Disabled widgets are removed from the list lazily by the panel, so the handle can still be in there.
+        if (polling && panel && std::ranges::find(panel->pollingWidgets, handle) == panel->pollingWidgets.end())
+            panel->pollingWidgets.push_back(handle);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Geometry.
+    ////////////////////////////////////////////////////////////////
+
+    MeshCache* Widget::getMeshCache() const noexcept { return panel ? &panel->meshCache : nullptr; }
+
+    TextMeshCache* Widget::getTextMeshCache() const noexcept { return panel ? panel->textMeshCache.get() : nullptr; }
+
+    InstanceBatches* Widget::getInstanceBatches() const noexcept
+    {
+        return panel && panel->instancing ? &panel->instanceBatches : nullptr;
+    }
+
+    StaticBatches* Widget::getStaticBatches() const noexcept
+    {
+        return panel && panel->batching ? &panel->staticBatches : nullptr;
     }
 
+    void Widget::releaseMesh(sol::IMesh*& mesh)
+    {
+        if (panel) panel->destructionQueue.enqueue(panel->meshCache, mesh);
+        mesh = nullptr;
+    }
+
+    void Widget::releaseTextMesh(sol::IMesh*& mesh)
+    {
+        if (panel) panel->destructionQueue.enqueue(*panel->textMeshCache, mesh);
+        mesh = nullptr;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scenegraph.
+    ////////////////////////////////////////////////////////////////
+
+    void Widget::ownNode(sol::Node& node) { ownedNodes.push_back(&node); }
+
+    std::any Widget::adoptNodes(const std::type_index               type,
+                                const sol::ForwardMaterialInstance* widgetMaterial,
+                                const sol::ForwardMaterialInstance* textMaterial)
+    {
+        nodePoolKey = NodePool::Key{.type = type, .widgetMaterial = widgetMaterial, .textMaterial = textMaterial};
+        if (!panel) return {};
+
+        NodePool::Entry entry;
+        if (!panel->nodePool.acquire(*nodePoolKey, entry)) return {};
+
+        ownedNodes = std::move(entry.roots);
+        return std::move(entry.nodes);
+    }
+
+    void Widget::poolNodes(std::any nodes)
+    {
+        if (!panel || !nodePoolKey || ownedNodes.empty()) return;
+
+        panel->nodePool.release(*nodePoolKey, {.nodes = std::move(nodes), .roots = std::move(ownedNodes)});
+        ownedNodes.clear();
+    }
+
+    bool Widget::nodeMaterialsChanged(const sol::ForwardMaterialInstance* widgetMaterial,
+                                      const sol::ForwardMaterialInstance* textMaterial) const noexcept
+    {
+        return nodePoolKey &&
+               (nodePoolKey->widgetMaterial != widgetMaterial || nodePoolKey->textMaterial != textMaterial);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Layout blocks.
+    ////////////////////////////////////////////////////////////////
+
+    void Widget::bindLayoutBlock(const LayoutElement& element, Block*& block)
+    {
+        if (element.getLayout() != layout.get())
+            throw FloahError("Cannot bind layout block. Element is not from the widget layout.");
+
+        layoutBlockBindings.emplace_back(LayoutBlockBinding{.element = &element, .block = &block});
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Style.
+    ////////////////////////////////////////////////////////////////
+
+    void Widget::resolveStyle() {}
+
+    void Widget::updateStyle()
+    {
+        if (!styleStale) return;
+        resolveStyle();
+        styleStale = false;
+    }
+
+    StyleCache* Widget::getStyleCache() const noexcept { return panel ? &panel->styleCache : nullptr; }
+
     ////////////////////////////////////////////////////////////////
     // Input.
     ////////////////////////////////////////////////////////////////